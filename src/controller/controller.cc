@@ -61,6 +61,7 @@ void Controller::LoadGraphFromFile() {
   try {
     graph_->LoadGraphFromFile(filename);
     graph_->PrintMatrix();
+    view_->DisplayLoadStats(graph_->LastLoadStats());
   } catch(...) {
     view_->ShowError("File does'n loaded");
   }
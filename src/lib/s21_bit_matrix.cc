@@ -0,0 +1,79 @@
+#include "s21_bit_matrix.h"
+
+#include <vector>
+
+#include "s21_thread_pool.h"
+
+namespace s21 {
+
+namespace {
+
+// Rows handed to one closure task at a time.
+const std::size_t kClosureGrain = 64;
+
+} // namespace
+
+BitMatrix::BitMatrix(const int size)
+    : size_(size), words_((static_cast<std::size_t>(size) + 63) / 64),
+      data_(words_ * size, 0) {}
+
+BitMatrix BitMatrix::FromGraph(const Graph &graph) {
+  BitMatrix matrix(graph.Size());
+  for (int vertex = 0; vertex < matrix.size_; ++vertex) {
+    for (Edge edge : graph.OutEdges(vertex)) {
+      matrix.Set(vertex, edge.to);
+    }
+  }
+  return matrix;
+}
+
+int BitMatrix::Count(const int vertex) const {
+  const std::uint64_t *row = Row(vertex);
+  int count = 0;
+  for (std::size_t word = 0; word < words_; ++word) {
+    count += __builtin_popcountll(row[word]);
+  }
+  return count;
+}
+
+vector<int> BitMatrix::Neighbors(const int vertex) const {
+  const std::uint64_t *row = Row(vertex);
+  vector<int> neighbors;
+  neighbors.reserve(Count(vertex));
+  for (std::size_t word = 0; word < words_; ++word) {
+    for (std::uint64_t bits = row[word]; bits; bits &= bits - 1) {
+      neighbors.push_back(static_cast<int>(word * 64) +
+                          __builtin_ctzll(bits));
+    }
+  }
+  return neighbors;
+}
+
+void BitMatrix::TransitiveClosure() {
+  ThreadPool pool(1);
+  TransitiveClosure(pool);
+}
+
+void BitMatrix::TransitiveClosure(ThreadPool &pool) {
+  for (int k = 0; k < size_; ++k) {
+    // Row k itself does not change in round k, so the other rows can read
+    // it while they are updated concurrently.
+    const std::uint64_t *through = Row(k);
+    std::size_t word_k = k >> 6;
+    std::uint64_t bit_k = std::uint64_t(1) << (k & 63);
+    pool.ParallelFor(
+        size_,
+        [&](std::size_t vertex, int) {
+          std::uint64_t *row = Row(static_cast<int>(vertex));
+          if (static_cast<int>(vertex) == k || !(row[word_k] & bit_k)) {
+            return;
+          }
+          for (std::size_t word = 0; word < words_; ++word) {
+            row[word] |= through[word];
+          }
+        },
+        kClosureGrain);
+  }
+}
+
+} // namespace s21
@@ -0,0 +1,62 @@
+#ifndef NAVIGATOR_SRC_LIB_S21_BIT_MATRIX_H_
+#define NAVIGATOR_SRC_LIB_S21_BIT_MATRIX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "s21_graph.h"
+
+namespace s21 {
+
+class ThreadPool;
+
+// Square 0/1 matrix packed 64 entries to a word, one row of Words() words
+// per vertex. As an adjacency matrix it takes 1/32 of an int matrix, and a
+// row's neighbors come out a word at a time: count by popcount, list by
+// counting trailing zeros.
+class BitMatrix {
+public:
+  BitMatrix() = default;
+  explicit BitMatrix(const int size);
+
+  // Bit (from, to) set for every arc; weights are dropped.
+  static BitMatrix FromGraph(const Graph &graph);
+
+  int Size() const { return size_; }
+  std::size_t Words() const { return words_; }
+  std::uint64_t *Row(const int vertex) {
+    return data_.data() + vertex * words_;
+  }
+  const std::uint64_t *Row(const int vertex) const {
+    return data_.data() + vertex * words_;
+  }
+  bool operator()(const int from, const int to) const {
+    return (Row(from)[to >> 6] >> (to & 63)) & 1;
+  }
+  void Set(const int from, const int to) {
+    Row(from)[to >> 6] |= std::uint64_t(1) << (to & 63);
+  }
+
+  // Set bits of a row, i.e. the out-degree in an adjacency matrix.
+  int Count(const int vertex) const;
+  // Columns set in a row, ascending, numbered from 0.
+  vector<int> Neighbors(const int vertex) const;
+
+  // Warshall's algorithm on whole rows: row i takes in row k whenever bit
+  // (i, k) is set, 64 columns per word operation. Afterwards bit (i, j)
+  // says j is reachable from i by a non-empty path, so (v, v) is set when
+  // v lies on a cycle.
+  void TransitiveClosure();
+  // The same with the rows of each round spread over the pool.
+  void TransitiveClosure(ThreadPool &pool);
+
+private:
+  int size_ = 0;
+  std::size_t words_ = 0;
+  vector<std::uint64_t> data_;
+};
+
+} // namespace s21
+
+#endif // NAVIGATOR_SRC_LIB_S21_BIT_MATRIX_H_
@@ -0,0 +1,599 @@
+#include "s21_contraction_hierarchy.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "s21_snapshot.h"
+#include "s21_thread_pool.h"
+
+namespace s21 {
+
+namespace {
+
+enum HierarchySection : std::uint32_t {
+  kRank = 1,
+  kUpOffsets,
+  kUpTargets,
+  kUpWeights,
+  kUpMiddles,
+  kDownOffsets,
+  kDownTargets,
+  kDownWeights,
+  kDownMiddles
+};
+
+// Witness searches give up after settling this many vertices and keep the
+// shortcut; that only costs an extra edge, never a wrong distance. Priority
+// estimates use a much tighter limit than the real contraction.
+const int kWitnessSettleLimit = 500;
+const int kPrioritySettleLimit = 15;
+
+struct DynamicEdge {
+  int to;
+  int weight;
+  int middle;
+};
+
+struct Shortcut {
+  int from;
+  int to;
+  int weight;
+  int middle;
+};
+
+using AdjacencyLists = vector<vector<DynamicEdge>>;
+
+// Keeps one edge per neighbor, the lightest one.
+void AddOrImprove(vector<DynamicEdge> &edges, const DynamicEdge &edge) {
+  for (DynamicEdge &existing : edges) {
+    if (existing.to == edge.to) {
+      if (edge.weight < existing.weight) {
+        existing = edge;
+      }
+      return;
+    }
+  }
+  edges.push_back(edge);
+}
+
+void RemoveNeighbor(vector<DynamicEdge> &edges, const int vertex) {
+  edges.erase(std::remove_if(edges.begin(), edges.end(),
+                             [vertex](const DynamicEdge &edge) {
+                               return edge.to == vertex;
+                             }),
+              edges.end());
+}
+
+// Per-thread Dijkstra state for witness searches.
+class WitnessSearch {
+public:
+  explicit WitnessSearch(const int size)
+      : distance_(size, kInf), heap_(size), target_(size, 0) {}
+
+  // Marks the vertices whose distances the next runs are for; a run stops
+  // once all of them are settled.
+  void SetTargets(const vector<DynamicEdge> &targets) {
+    for (const DynamicEdge &edge : targets) {
+      target_[edge.to] = 1;
+    }
+    target_count_ = static_cast<int>(targets.size());
+  }
+  void ClearTargets(const vector<DynamicEdge> &targets) {
+    for (const DynamicEdge &edge : targets) {
+      target_[edge.to] = 0;
+    }
+  }
+
+  // Distances from source in the remaining graph, ignoring vertices for
+  // which skip returns true, up to limit.
+  template <class Skip>
+  void Run(const AdjacencyLists &out, const int source, const int limit,
+           const int settle_limit, const Skip &skip) {
+    Reset();
+    distance_[source] = 0;
+    touched_.push_back(source);
+    heap_.push(source, 0);
+    int settled = 0;
+    int settled_targets = 0;
+    while (!heap_.empty() && heap_.top_key() <= limit &&
+           settled < settle_limit && settled_targets < target_count_) {
+      int vertex = heap_.top();
+      heap_.pop();
+      ++settled;
+      settled_targets += target_[vertex];
+      for (const DynamicEdge &edge : out[vertex]) {
+        if (skip(edge.to)) {
+          continue;
+        }
+        int new_distance = distance_[vertex] + edge.weight;
+        if (new_distance < distance_[edge.to]) {
+          if (distance_[edge.to] == kInf) {
+            touched_.push_back(edge.to);
+          }
+          distance_[edge.to] = new_distance;
+          heap_.push_or_decrease(edge.to, new_distance);
+        }
+      }
+    }
+  }
+
+  int Distance(const int vertex) const { return distance_[vertex]; }
+
+private:
+  void Reset() {
+    for (int vertex : touched_) {
+      distance_[vertex] = kInf;
+    }
+    touched_.clear();
+    heap_.clear();
+  }
+
+  vector<int> distance_;
+  IndexedHeap<int> heap_;
+  vector<int> touched_;
+  vector<char> target_;
+  int target_count_ = 0;
+};
+
+// Shortcuts needed to contract vertex; when shortcuts is null they are
+// only counted.
+template <class Skip>
+int Contract(const AdjacencyLists &out, const AdjacencyLists &in,
+             const int vertex, WitnessSearch &search, const Skip &skip,
+             vector<Shortcut> *shortcuts) {
+  int settle_limit =
+      shortcuts == nullptr ? kPrioritySettleLimit : kWitnessSettleLimit;
+  int count = 0;
+  search.SetTargets(out[vertex]);
+  for (const DynamicEdge &incoming : in[vertex]) {
+    int limit = 0;
+    for (const DynamicEdge &outgoing : out[vertex]) {
+      if (outgoing.to != incoming.to) {
+        limit = std::max(limit, incoming.weight + outgoing.weight);
+      }
+    }
+    if (limit == 0) {
+      continue;
+    }
+    search.Run(out, incoming.to, limit, settle_limit,
+               [&skip, vertex](const int other) {
+      return other == vertex || skip(other);
+    });
+    for (const DynamicEdge &outgoing : out[vertex]) {
+      int via = incoming.weight + outgoing.weight;
+      if (outgoing.to != incoming.to && search.Distance(outgoing.to) > via) {
+        ++count;
+        if (shortcuts != nullptr) {
+          shortcuts->push_back(Shortcut{incoming.to, outgoing.to, via, vertex});
+        }
+      }
+    }
+  }
+  search.ClearTargets(out[vertex]);
+  return count;
+}
+
+unsigned TieBreak(const int vertex) {
+  return static_cast<unsigned>(vertex) * 2654435761u;
+}
+
+void Flatten(const vector<vector<DynamicEdge>> &lists,
+             SharedArray<std::size_t> &offsets_out, SharedArray<int> &targets_out,
+             SharedArray<int> &weights_out, SharedArray<int> &middles_out) {
+  vector<std::size_t> offsets(1, 0);
+  vector<int> targets;
+  vector<int> weights;
+  vector<int> middles;
+  for (const vector<DynamicEdge> &list : lists) {
+    vector<DynamicEdge> sorted = list;
+    std::sort(sorted.begin(), sorted.end(),
+              [](const DynamicEdge &a, const DynamicEdge &b) {
+                return a.to < b.to;
+              });
+    for (const DynamicEdge &edge : sorted) {
+      targets.push_back(edge.to);
+      weights.push_back(edge.weight);
+      middles.push_back(edge.middle);
+    }
+    offsets.push_back(targets.size());
+  }
+  offsets_out = std::move(offsets);
+  targets_out = std::move(targets);
+  weights_out = std::move(weights);
+  middles_out = std::move(middles);
+}
+
+} // namespace
+
+ContractionHierarchy ContractionHierarchy::Build(const Graph &graph,
+                                                 int threads) {
+  int size = graph.Size();
+  if (size == 0) {
+    throw "contractionhierarchy: empty graph";
+  }
+  ThreadPool pool(threads);
+  vector<WitnessSearch> searches(pool.Size(), WitnessSearch(size));
+
+  AdjacencyLists out(size);
+  AdjacencyLists in(size);
+  for (int v = 0; v < size; ++v) {
+    for (Edge edge : graph.OutEdges(v)) {
+      if (edge.to != v) {
+        out[v].push_back(DynamicEdge{edge.to, edge.weight, -1});
+        in[edge.to].push_back(DynamicEdge{v, edge.weight, -1});
+      }
+    }
+  }
+
+  vector<int> priority(size, 0);
+  vector<int> deleted_neighbors(size, 0);
+  vector<int> level(size, 0);
+  vector<char> contracted(size, 0);
+  vector<char> contracting(size, 0);
+  auto never = [](const int) { return false; };
+  auto update_priority = [&](const int vertex, const int worker) {
+    int shortcuts =
+        Contract(out, in, vertex, searches[worker], never, nullptr);
+    int degree = static_cast<int>(out[vertex].size() + in[vertex].size());
+    // Edge difference keeps the graph sparse, deleted neighbors and level
+    // spread contraction evenly over the graph.
+    priority[vertex] = 4 * shortcuts - 2 * degree + deleted_neighbors[vertex] +
+                       2 * level[vertex];
+  };
+
+  vector<int> remaining(size);
+  for (int v = 0; v < size; ++v) {
+    remaining[v] = v;
+  }
+  pool.ParallelFor(
+      remaining.size(),
+      [&](std::size_t i, int worker) { update_priority(remaining[i], worker); },
+      64);
+
+  ContractionHierarchy result;
+  result.size_ = size;
+  result.edge_count_ = graph.EdgeCount();
+  vector<int> rank(size, 0);
+  AdjacencyLists up(size);
+  AdjacencyLists down(size);
+  int next_rank = 0;
+  vector<char> selected(size, 0);
+  vector<char> dirty(size, 0);
+
+  while (!remaining.empty()) {
+    // A vertex is contracted this round if it beats every neighbor on
+    // (priority, tie break); such vertices are never adjacent.
+    auto less = [&](const int a, const int b) {
+      return priority[a] < priority[b] ||
+             (priority[a] == priority[b] && TieBreak(a) < TieBreak(b));
+    };
+    pool.ParallelFor(
+        remaining.size(),
+        [&](std::size_t i, int) {
+          int v = remaining[i];
+          bool best = true;
+          for (const DynamicEdge &edge : out[v]) {
+            best = best && less(v, edge.to);
+          }
+          for (const DynamicEdge &edge : in[v]) {
+            best = best && less(v, edge.to);
+          }
+          selected[v] = best;
+        },
+        256);
+    vector<int> batch;
+    for (int v : remaining) {
+      if (selected[v]) {
+        batch.push_back(v);
+        contracting[v] = 1;
+      }
+    }
+
+    vector<vector<Shortcut>> shortcuts(batch.size());
+    auto skip = [&contracting](const int other) { return contracting[other] != 0; };
+    pool.ParallelFor(
+        batch.size(),
+        [&](std::size_t i, int worker) {
+          Contract(out, in, batch[i], searches[worker], skip, &shortcuts[i]);
+        },
+        16);
+
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+      int v = batch[i];
+      rank[v] = next_rank++;
+      up[v] = std::move(out[v]);
+      down[v] = std::move(in[v]);
+      for (const DynamicEdge &edge : up[v]) {
+        RemoveNeighbor(in[edge.to], v);
+        ++deleted_neighbors[edge.to];
+        level[edge.to] = std::max(level[edge.to], level[v] + 1);
+        dirty[edge.to] = 1;
+      }
+      for (const DynamicEdge &edge : down[v]) {
+        RemoveNeighbor(out[edge.to], v);
+        ++deleted_neighbors[edge.to];
+        level[edge.to] = std::max(level[edge.to], level[v] + 1);
+        dirty[edge.to] = 1;
+      }
+      for (const Shortcut &shortcut : shortcuts[i]) {
+        AddOrImprove(out[shortcut.from],
+                     DynamicEdge{shortcut.to, shortcut.weight, shortcut.middle});
+        AddOrImprove(in[shortcut.to], DynamicEdge{shortcut.from,
+                                                  shortcut.weight,
+                                                  shortcut.middle});
+      }
+      out[v] = vector<DynamicEdge>();
+      in[v] = vector<DynamicEdge>();
+      contracted[v] = 1;
+      contracting[v] = 0;
+      selected[v] = 0;
+    }
+
+    vector<int> next_remaining;
+    vector<int> update;
+    for (int v : remaining) {
+      if (!contracted[v]) {
+        next_remaining.push_back(v);
+        if (dirty[v]) {
+          update.push_back(v);
+          dirty[v] = 0;
+        }
+      }
+    }
+    remaining.swap(next_remaining);
+    pool.ParallelFor(
+        update.size(),
+        [&](std::size_t i, int worker) { update_priority(update[i], worker); },
+        16);
+  }
+
+  for (int v = 0; v < size; ++v) {
+    for (const DynamicEdge &edge : up[v]) {
+      result.shortcut_count_ += edge.middle >= 0;
+    }
+    for (const DynamicEdge &edge : down[v]) {
+      result.shortcut_count_ += edge.middle >= 0;
+    }
+  }
+  result.rank_ = std::move(rank);
+  Flatten(up, result.up_.offsets, result.up_.targets, result.up_.weights,
+          result.up_.middles);
+  Flatten(down, result.down_.offsets, result.down_.targets,
+          result.down_.weights, result.down_.middles);
+  return result;
+}
+
+void ContractionHierarchy::CheckVertices(const int vertex1,
+                                         const int vertex2) const {
+  if (vertex1 < 1 || vertex1 > size_ || vertex2 < 1 || vertex2 > size_) {
+    throw "";
+  }
+}
+
+int ContractionHierarchy::Distance(const int vertex1, const int vertex2) const {
+  Query query(*this);
+  return query.Distance(vertex1, vertex2);
+}
+
+ShortestPath ContractionHierarchy::Path(const int vertex1,
+                                        const int vertex2) const {
+  Query query(*this);
+  return query.Path(vertex1, vertex2);
+}
+
+std::size_t ContractionHierarchy::FindEdge(const Edges &edges,
+                                           const int vertex,
+                                           const int other) const {
+  const int *first = edges.targets.data() + edges.offsets[vertex];
+  const int *last = edges.targets.data() + edges.offsets[vertex + 1];
+  const int *found = std::lower_bound(first, last, other);
+  if (found == last || *found != other) {
+    throw "contractionhierarchy: broken shortcut";
+  }
+  return static_cast<std::size_t>(found - edges.targets.data());
+}
+
+ContractionHierarchy::Query::Query(const ContractionHierarchy &hierarchy)
+    : hierarchy_(hierarchy) {
+  int size = hierarchy.Size();
+  for (int side = 0; side < 2; ++side) {
+    distance_[side].assign(size, kInf);
+    parent_[side].assign(size, -1);
+    parent_edge_[side].assign(size, 0);
+    heap_[side].resize(size);
+  }
+}
+
+void ContractionHierarchy::Query::Reset() {
+  for (int vertex : touched_) {
+    distance_[0][vertex] = kInf;
+    distance_[1][vertex] = kInf;
+  }
+  touched_.clear();
+  heap_[0].clear();
+  heap_[1].clear();
+  meeting_ = -1;
+}
+
+int ContractionHierarchy::Query::Search(const int source, const int target) {
+  Reset();
+  distance_[0][source] = 0;
+  distance_[1][target] = 0;
+  parent_[0][source] = -1;
+  parent_[1][target] = -1;
+  touched_.push_back(source);
+  touched_.push_back(target);
+  heap_[0].push(source, 0);
+  heap_[1].push(target, 0);
+  long long best = kInf;
+
+  // Upward keys from the two sides are not comparable, so each side runs
+  // until its own minimum reaches the best meeting distance.
+  while (true) {
+    bool open[2];
+    for (int side = 0; side < 2; ++side) {
+      open[side] = !heap_[side].empty() && heap_[side].top_key() < best;
+    }
+    if (!open[0] && !open[1]) {
+      break;
+    }
+    int side = !open[1] || (open[0] && heap_[0].top_key() <= heap_[1].top_key())
+                   ? 0
+                   : 1;
+    int vertex = heap_[side].top();
+    heap_[side].pop();
+    if (distance_[1 - side][vertex] != kInf &&
+        static_cast<long long>(distance_[0][vertex]) + distance_[1][vertex] <
+            best) {
+      best = static_cast<long long>(distance_[0][vertex]) + distance_[1][vertex];
+      meeting_ = vertex;
+    }
+    // Stall on demand: a higher vertex already reached by this side that
+    // reaches vertex more cheaply proves vertex is not on a shortest path.
+    const Edges &edges = side == 0 ? hierarchy_.up_ : hierarchy_.down_;
+    const Edges &opposite = side == 0 ? hierarchy_.down_ : hierarchy_.up_;
+    bool stalled = false;
+    for (std::size_t e = opposite.offsets[vertex];
+         e < opposite.offsets[vertex + 1] && !stalled; ++e) {
+      int higher = distance_[side][opposite.targets[e]];
+      stalled = higher != kInf &&
+                higher + opposite.weights[e] < distance_[side][vertex];
+    }
+    if (stalled) {
+      continue;
+    }
+    for (std::size_t e = edges.offsets[vertex]; e < edges.offsets[vertex + 1];
+         ++e) {
+      int next = edges.targets[e];
+      int new_distance = distance_[side][vertex] + edges.weights[e];
+      if (new_distance < distance_[side][next]) {
+        if (distance_[0][next] == kInf && distance_[1][next] == kInf) {
+          touched_.push_back(next);
+        }
+        distance_[side][next] = new_distance;
+        parent_[side][next] = vertex;
+        parent_edge_[side][next] = e;
+        heap_[side].push_or_decrease(next, new_distance);
+      }
+    }
+  }
+  return best >= kInf ? kInf : static_cast<int>(best);
+}
+
+int ContractionHierarchy::Query::Distance(const int vertex1,
+                                          const int vertex2) {
+  hierarchy_.CheckVertices(vertex1, vertex2);
+  return Search(vertex1 - 1, vertex2 - 1);
+}
+
+ShortestPath ContractionHierarchy::Query::Path(const int vertex1,
+                                               const int vertex2) {
+  hierarchy_.CheckVertices(vertex1, vertex2);
+  ShortestPath result{Search(vertex1 - 1, vertex2 - 1), {}};
+  if (result.distance == kInf) {
+    return result;
+  }
+  // Packed edges from the source up to the meeting vertex...
+  vector<std::pair<int, std::size_t>> upward;
+  for (int v = meeting_; parent_[0][v] != -1; v = parent_[0][v]) {
+    upward.emplace_back(parent_[0][v], parent_edge_[0][v]);
+  }
+  result.vertices.push_back(vertex1 - 1);
+  for (auto it = upward.rbegin(); it != upward.rend(); ++it) {
+    Unpack(it->first, it->second, true, result.vertices);
+  }
+  // ...and from the meeting vertex down to the target.
+  for (int v = meeting_; parent_[1][v] != -1; v = parent_[1][v]) {
+    Unpack(parent_[1][v], parent_edge_[1][v], false, result.vertices);
+  }
+  for (int &vertex : result.vertices) {
+    ++vertex;
+  }
+  return result;
+}
+
+void ContractionHierarchy::Query::Unpack(const int owner,
+                                         const std::size_t edge,
+                                         const bool upward,
+                                         vector<int> &path) const {
+  // Each entry is an edge stored at owner: owner -> target when upward,
+  // target -> owner otherwise. Shortcuts split into two edges at their
+  // middle vertex, which is stored in the middle's own lists.
+  struct Pending {
+    int owner;
+    std::size_t edge;
+    bool upward;
+  };
+  vector<Pending> stack = {Pending{owner, edge, upward}};
+  while (!stack.empty()) {
+    Pending top = stack.back();
+    stack.pop_back();
+    const Edges &edges = top.upward ? hierarchy_.up_ : hierarchy_.down_;
+    int other = edges.targets[top.edge];
+    int middle = edges.middles[top.edge];
+    int from = top.upward ? top.owner : other;
+    int to = top.upward ? other : top.owner;
+    if (middle < 0) {
+      path.push_back(to);
+      continue;
+    }
+    stack.push_back(
+        Pending{middle, hierarchy_.FindEdge(hierarchy_.up_, middle, to), true});
+    stack.push_back(Pending{
+        middle, hierarchy_.FindEdge(hierarchy_.down_, middle, from), false});
+  }
+}
+
+void ContractionHierarchy::Save(std::string filename) const {
+  SnapshotWriter writer(kHierarchySnapshotKind, kHierarchySnapshotVersion);
+  writer.SetValue(0, static_cast<std::uint64_t>(size_));
+  writer.SetValue(1, edge_count_);
+  writer.SetValue(2, up_.targets.size());
+  writer.SetValue(3, down_.targets.size());
+  writer.SetValue(4, shortcut_count_);
+  writer.AddSection(kRank, rank_.data(), rank_.size());
+  writer.AddSection(kUpOffsets, up_.offsets.data(), up_.offsets.size());
+  writer.AddSection(kUpTargets, up_.targets.data(), up_.targets.size());
+  writer.AddSection(kUpWeights, up_.weights.data(), up_.weights.size());
+  writer.AddSection(kUpMiddles, up_.middles.data(), up_.middles.size());
+  writer.AddSection(kDownOffsets, down_.offsets.data(), down_.offsets.size());
+  writer.AddSection(kDownTargets, down_.targets.data(), down_.targets.size());
+  writer.AddSection(kDownWeights, down_.weights.data(), down_.weights.size());
+  writer.AddSection(kDownMiddles, down_.middles.data(), down_.middles.size());
+  writer.Write(filename);
+}
+
+void ContractionHierarchy::Load(std::string filename, const Graph &graph) {
+  SnapshotReader reader(filename, kHierarchySnapshotKind,
+                        kHierarchySnapshotVersion, true);
+  std::uint64_t size = reader.Value(0);
+  if (size == 0 || size != static_cast<std::uint64_t>(graph.Size()) ||
+      reader.Value(1) != graph.EdgeCount()) {
+    throw "contractionhierarchy: hierarchy does not match the graph";
+  }
+  std::uint64_t up_count = reader.Value(2);
+  std::uint64_t down_count = reader.Value(3);
+  Edges up{reader.Section<std::size_t>(kUpOffsets, size + 1),
+           reader.Section<int>(kUpTargets, up_count),
+           reader.Section<int>(kUpWeights, up_count),
+           reader.Section<int>(kUpMiddles, up_count)};
+  Edges down{reader.Section<std::size_t>(kDownOffsets, size + 1),
+             reader.Section<int>(kDownTargets, down_count),
+             reader.Section<int>(kDownWeights, down_count),
+             reader.Section<int>(kDownMiddles, down_count)};
+  auto rank = reader.Section<int>(kRank, size);
+  if (up.offsets[size] != up_count || down.offsets[size] != down_count) {
+    throw "contractionhierarchy: wrong file";
+  }
+
+  size_ = static_cast<int>(size);
+  edge_count_ = graph.EdgeCount();
+  shortcut_count_ = reader.Value(4);
+  rank_ = std::move(rank);
+  up_ = std::move(up);
+  down_ = std::move(down);
+}
+
+} // namespace s21
@@ -0,0 +1,94 @@
+#ifndef NAVIGATOR_SRC_LIB_S21_CONTRACTION_HIERARCHY_H_
+#define NAVIGATOR_SRC_LIB_S21_CONTRACTION_HIERARCHY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "s21_graph.h"
+#include "s21_graph_algorithms.h"
+#include "s21_indexed_heap.h"
+#include "s21_shared_array.h"
+
+namespace s21 {
+
+// Snapshot kind "CHIE" and the layout version written by Save.
+const std::uint32_t kHierarchySnapshotKind = 0x45494843;
+const std::uint32_t kHierarchySnapshotVersion = 1;
+
+// Contraction Hierarchies. Vertices are contracted one level at a time in
+// order of importance; contracting v adds a shortcut u -> w for every path
+// u -> v -> w that no witness path avoiding v can match. A query is then a
+// bidirectional Dijkstra that only climbs to higher-ranked vertices.
+//
+// Every edge is stored at its lower-ranked endpoint: the upward list of v
+// holds v -> w and the downward list holds u -> v, both with rank above v.
+// A shortcut records the contracted middle vertex so paths can be unpacked.
+class ContractionHierarchy {
+public:
+  ContractionHierarchy() = default;
+
+  // Contracts an independent set of locally least important vertices per
+  // round; witness searches and priorities are spread over threads
+  // (0 = one per hardware thread).
+  static ContractionHierarchy Build(const Graph &graph, int threads = 0);
+
+  int Size() const { return size_; }
+  std::size_t ShortcutCount() const { return shortcut_count_; }
+  int Rank(const int vertex) const { return rank_[vertex]; }
+
+  // Convenience queries with a throwaway workspace; vertices from 1.
+  int Distance(const int vertex1, const int vertex2) const;
+  ShortestPath Path(const int vertex1, const int vertex2) const;
+
+  void Save(std::string filename) const;
+  void Load(std::string filename, const Graph &graph);
+
+  // Reusable query workspace; reset cost is proportional to the vertices
+  // the previous query touched, not to the graph size.
+  class Query {
+  public:
+    explicit Query(const ContractionHierarchy &hierarchy);
+
+    int Distance(const int vertex1, const int vertex2);
+    ShortestPath Path(const int vertex1, const int vertex2);
+
+  private:
+    int Search(const int source, const int target);
+    void Reset();
+    void Unpack(const int from, const std::size_t edge, const bool upward,
+                vector<int> &path) const;
+
+    const ContractionHierarchy &hierarchy_;
+    vector<int> distance_[2];
+    vector<int> parent_[2];
+    vector<std::size_t> parent_edge_[2];
+    IndexedHeap<int> heap_[2];
+    vector<int> touched_;
+    int meeting_ = -1;
+  };
+
+private:
+  struct Edges {
+    SharedArray<std::size_t> offsets;
+    SharedArray<int> targets;
+    SharedArray<int> weights;
+    SharedArray<int> middles;
+  };
+
+  std::size_t FindEdge(const Edges &edges, const int vertex,
+                       const int other) const;
+  void CheckVertices(const int vertex1, const int vertex2) const;
+
+  int size_ = 0;
+  std::uint64_t edge_count_ = 0;
+  std::size_t shortcut_count_ = 0;
+  SharedArray<int> rank_;
+  Edges up_;
+  Edges down_;
+};
+
+} // namespace s21
+
+#endif // NAVIGATOR_SRC_LIB_S21_CONTRACTION_HIERARCHY_H_
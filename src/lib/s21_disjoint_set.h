@@ -0,0 +1,118 @@
+#ifndef NAVIGATOR_SRC_LIB_S21_DISJOINT_SET_H_
+#define NAVIGATOR_SRC_LIB_S21_DISJOINT_SET_H_
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+
+// Union-find over items in [0, size) with union by rank and full path
+// compression, so a sequence of operations is nearly linear.
+class DisjointSet {
+public:
+  DisjointSet() = default;
+  explicit DisjointSet(const int size)
+      : parent_(size), rank_(size, 0), count_(size) {
+    for (int item = 0; item < size; ++item) {
+      parent_[item] = item;
+    }
+  }
+
+  int Size() const { return static_cast<int>(parent_.size()); }
+  // Number of disjoint sets left.
+  int Count() const { return count_; }
+
+  int Find(int item) {
+    int root = item;
+    while (parent_[root] != root) {
+      root = parent_[root];
+    }
+    while (parent_[item] != root) {
+      int next = parent_[item];
+      parent_[item] = root;
+      item = next;
+    }
+    return root;
+  }
+
+  // Merges the sets of a and b; false if they were already one set.
+  bool Unite(const int a, const int b) {
+    int root_a = Find(a);
+    int root_b = Find(b);
+    if (root_a == root_b) {
+      return false;
+    }
+    if (rank_[root_a] < rank_[root_b]) {
+      std::swap(root_a, root_b);
+    }
+    parent_[root_b] = root_a;
+    if (rank_[root_a] == rank_[root_b]) {
+      ++rank_[root_a];
+    }
+    --count_;
+    return true;
+  }
+
+private:
+  std::vector<int> parent_;
+  std::vector<int> rank_;
+  int count_ = 0;
+};
+
+// Lock-free union-find for concurrent Unite and Find calls. Roots are only
+// ever linked under a root with a smaller index, so a failed compare and
+// swap just means another thread got there first and the call retries.
+// Find shortens paths by halving.
+class ConcurrentDisjointSet {
+public:
+  explicit ConcurrentDisjointSet(const int size)
+      : parent_(size), count_(size) {
+    for (int item = 0; item < size; ++item) {
+      parent_[item].store(item, std::memory_order_relaxed);
+    }
+  }
+
+  int Size() const { return static_cast<int>(parent_.size()); }
+  int Count() const { return count_.load(); }
+
+  int Find(int item) {
+    while (true) {
+      int parent = parent_[item].load();
+      if (parent == item) {
+        return item;
+      }
+      int grandparent = parent_[parent].load();
+      if (parent != grandparent) {
+        parent_[item].compare_exchange_weak(parent, grandparent);
+      }
+      item = grandparent;
+    }
+  }
+
+  bool Unite(int a, int b) {
+    while (true) {
+      a = Find(a);
+      b = Find(b);
+      if (a == b) {
+        return false;
+      }
+      if (a < b) {
+        std::swap(a, b);
+      }
+      int expected = a;
+      if (parent_[a].compare_exchange_strong(expected, b)) {
+        count_.fetch_sub(1);
+        return true;
+      }
+    }
+  }
+
+private:
+  std::vector<std::atomic<int>> parent_;
+  std::atomic<int> count_;
+};
+
+} // namespace s21
+
+#endif // NAVIGATOR_SRC_LIB_S21_DISJOINT_SET_H_
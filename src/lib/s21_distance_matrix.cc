@@ -0,0 +1,215 @@
+#include "s21_distance_matrix.h"
+
+#include <vector>
+
+#include "s21_thread_pool.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define S21_X86_KERNELS
+#endif
+
+namespace s21 {
+
+namespace {
+
+const int kBlock = DistanceMatrix::kBlock;
+
+// Every kernel relaxes tile c through the pivot columns of tile a and the
+// pivot rows of tile b: c[i][j] = min(c[i][j], a[i][k] + b[k][j]) for k in
+// tile order. Entries are at most kInf, so their unsigned sum cannot wrap
+// and an unsigned min leaves kInf in place without a branch. The tiles may
+// be the same; weights are positive, so the pivot row and column do not
+// change while they are used.
+using TileKernel = void (*)(int *c, const int *a, const int *b,
+                            const std::size_t stride);
+
+void RelaxTileScalar(int *c, const int *a, const int *b,
+                     const std::size_t stride) {
+  for (int k = 0; k < kBlock; ++k) {
+    const int *b_row = b + k * stride;
+    for (int i = 0; i < kBlock; ++i) {
+      int through = a[i * stride + k];
+      if (through == kInf) {
+        continue;
+      }
+      unsigned base = static_cast<unsigned>(through);
+      int *c_row = c + i * stride;
+      for (int j = 0; j < kBlock; ++j) {
+        unsigned candidate = base + static_cast<unsigned>(b_row[j]);
+        unsigned current = static_cast<unsigned>(c_row[j]);
+        c_row[j] = static_cast<int>(candidate < current ? candidate : current);
+      }
+    }
+  }
+}
+
+#ifdef S21_X86_KERNELS
+__attribute__((target("sse4.1"))) void
+RelaxTileSse41(int *c, const int *a, const int *b, const std::size_t stride) {
+  for (int k = 0; k < kBlock; ++k) {
+    const int *b_row = b + k * stride;
+    for (int i = 0; i < kBlock; ++i) {
+      int through = a[i * stride + k];
+      if (through == kInf) {
+        continue;
+      }
+      __m128i base = _mm_set1_epi32(through);
+      int *c_row = c + i * stride;
+      for (int j = 0; j < kBlock; j += 4) {
+        __m128i candidate = _mm_add_epi32(
+            base,
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(b_row + j)));
+        __m128i current =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(c_row + j));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(c_row + j),
+                         _mm_min_epu32(candidate, current));
+      }
+    }
+  }
+}
+
+__attribute__((target("avx2"))) void
+RelaxTileAvx2(int *c, const int *a, const int *b, const std::size_t stride) {
+  for (int k = 0; k < kBlock; ++k) {
+    const int *b_row = b + k * stride;
+    for (int i = 0; i < kBlock; ++i) {
+      int through = a[i * stride + k];
+      if (through == kInf) {
+        continue;
+      }
+      __m256i base = _mm256_set1_epi32(through);
+      int *c_row = c + i * stride;
+      for (int j = 0; j < kBlock; j += 8) {
+        __m256i candidate = _mm256_add_epi32(
+            base,
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b_row + j)));
+        __m256i current =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(c_row + j));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(c_row + j),
+                            _mm256_min_epu32(candidate, current));
+      }
+    }
+  }
+}
+
+// Tile c is disjoint from a and b, so each row of c stays in registers for
+// the whole pivot range instead of being reloaded per pivot.
+__attribute__((target("avx2"))) void
+RelaxDisjointTileAvx2(int *c, const int *a, const int *b,
+                      const std::size_t stride) {
+  static_assert(kBlock == 32, "one tile row is four AVX2 registers");
+  for (int i = 0; i < kBlock; ++i) {
+    int *c_row = c + i * stride;
+    const int *a_row = a + i * stride;
+    __m256i row0 = _mm256_loadu_si256(reinterpret_cast<__m256i *>(c_row));
+    __m256i row1 = _mm256_loadu_si256(reinterpret_cast<__m256i *>(c_row + 8));
+    __m256i row2 = _mm256_loadu_si256(reinterpret_cast<__m256i *>(c_row + 16));
+    __m256i row3 = _mm256_loadu_si256(reinterpret_cast<__m256i *>(c_row + 24));
+    for (int k = 0; k < kBlock; ++k) {
+      if (a_row[k] == kInf) {
+        continue;
+      }
+      __m256i base = _mm256_set1_epi32(a_row[k]);
+      const __m256i *b_row = reinterpret_cast<const __m256i *>(b + k * stride);
+      row0 = _mm256_min_epu32(
+          row0, _mm256_add_epi32(base, _mm256_loadu_si256(b_row)));
+      row1 = _mm256_min_epu32(
+          row1, _mm256_add_epi32(base, _mm256_loadu_si256(b_row + 1)));
+      row2 = _mm256_min_epu32(
+          row2, _mm256_add_epi32(base, _mm256_loadu_si256(b_row + 2)));
+      row3 = _mm256_min_epu32(
+          row3, _mm256_add_epi32(base, _mm256_loadu_si256(b_row + 3)));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(c_row), row0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(c_row + 8), row1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(c_row + 16), row2);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(c_row + 24), row3);
+  }
+}
+#endif
+
+// The general kernel handles tiles that overlap their pivot tiles; the
+// disjoint one may assume they do not.
+struct Kernels {
+  TileKernel general;
+  TileKernel disjoint;
+};
+
+Kernels SelectKernels() {
+#ifdef S21_X86_KERNELS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return Kernels{RelaxTileAvx2, RelaxDisjointTileAvx2};
+  }
+  if (__builtin_cpu_supports("sse4.1")) {
+    return Kernels{RelaxTileSse41, RelaxTileSse41};
+  }
+#endif
+  return Kernels{RelaxTileScalar, RelaxTileScalar};
+}
+
+} // namespace
+
+DistanceMatrix::DistanceMatrix(const int size)
+    : size_(size),
+      stride_(static_cast<std::size_t>((size + kBlock - 1) / kBlock * kBlock)),
+      data_(stride_ * stride_, kInf) {}
+
+DistanceMatrix DistanceMatrix::FromGraph(const Graph &graph) {
+  DistanceMatrix matrix(graph.Size());
+  for (int i = 0; i < graph.Size(); ++i) {
+    int *row = matrix.Row(i);
+    for (Edge edge : graph.OutEdges(i)) {
+      row[edge.to] = edge.weight;
+    }
+  }
+  return matrix;
+}
+
+void DistanceMatrix::FloydWarshall() {
+  ThreadPool pool(1);
+  FloydWarshall(pool);
+}
+
+void DistanceMatrix::FloydWarshall(ThreadPool &pool) {
+  static const Kernels kernels = SelectKernels();
+  int blocks = static_cast<int>(stride_ / kBlock);
+  auto tile = [this](const int row, const int column) {
+    return data_.data() + row * kBlock * stride_ + column * kBlock;
+  };
+
+  // Round k first closes the pivot tile, then the tiles sharing its block
+  // row or column, and finally every other tile through those two panels.
+  // Tiles within the last two steps are independent of each other.
+  for (int k = 0; k < blocks; ++k) {
+    int *pivot = tile(k, k);
+    kernels.general(pivot, pivot, pivot, stride_);
+    pool.ParallelFor(2 * (blocks - 1), [&](std::size_t index, int) {
+      int other = static_cast<int>(index) / 2;
+      other += other >= k;
+      if (index % 2 == 0) {
+        kernels.general(tile(k, other), pivot, tile(k, other), stride_);
+      } else {
+        kernels.general(tile(other, k), tile(other, k), pivot, stride_);
+      }
+    });
+    pool.ParallelFor((blocks - 1) * (blocks - 1), [&](std::size_t index, int) {
+      int i = static_cast<int>(index) / (blocks - 1);
+      int j = static_cast<int>(index) % (blocks - 1);
+      i += i >= k;
+      j += j >= k;
+      kernels.disjoint(tile(i, j), tile(i, k), tile(k, j), stride_);
+    });
+  }
+}
+
+vector<vector<int>> DistanceMatrix::ToVectors() const {
+  vector<vector<int>> result(size_);
+  for (int i = 0; i < size_; ++i) {
+    result[i].assign(Row(i), Row(i) + size_);
+  }
+  return result;
+}
+
+} // namespace s21
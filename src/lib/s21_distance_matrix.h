@@ -0,0 +1,58 @@
+#ifndef NAVIGATOR_SRC_LIB_S21_DISTANCE_MATRIX_H_
+#define NAVIGATOR_SRC_LIB_S21_DISTANCE_MATRIX_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "s21_graph.h"
+#include "s21_graph_algorithms.h"
+
+namespace s21 {
+
+class ThreadPool;
+
+// Square matrix of path lengths in one contiguous buffer, kInf meaning "no
+// path". Both dimensions are padded with kInf up to a multiple of the tile
+// size, so the blocked kernels only ever see full tiles; padded vertices
+// have no edges and never shorten a path.
+class DistanceMatrix {
+public:
+  // Tile edge in entries; three int tiles fit in L1 together.
+  static const int kBlock = 32;
+
+  DistanceMatrix() = default;
+  explicit DistanceMatrix(const int size);
+
+  // Edge weights, kInf where there is no edge (including the diagonal
+  // unless the vertex has a self-loop).
+  static DistanceMatrix FromGraph(const Graph &graph);
+
+  int Size() const { return size_; }
+  std::size_t Stride() const { return stride_; }
+  int *Row(const int vertex) { return data_.data() + vertex * stride_; }
+  const int *Row(const int vertex) const {
+    return data_.data() + vertex * stride_;
+  }
+  int operator()(const int from, const int to) const {
+    return data_[from * stride_ + to];
+  }
+
+  // Blocked Floyd-Warshall in place. Afterwards entry (v, v) is the
+  // shortest cycle through v, as in the textbook version. The min-plus
+  // kernel saturates instead of branching on kInf and uses AVX2 or SSE4.1
+  // when the CPU has them.
+  void FloydWarshall();
+  // The same with the tiles of each round spread over the pool.
+  void FloydWarshall(ThreadPool &pool);
+
+  vector<vector<int>> ToVectors() const;
+
+private:
+  int size_ = 0;
+  std::size_t stride_ = 0;
+  vector<int> data_;
+};
+
+} // namespace s21
+
+#endif // NAVIGATOR_SRC_LIB_S21_DISTANCE_MATRIX_H_
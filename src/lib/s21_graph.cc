@@ -1,28 +1,53 @@
 #include "s21_graph.h"
 
 #include <algorithm>
+#include <charconv>
+#include <chrono>
 #include <exception>
 #include <fstream>
 #include <iostream>
-#include <sstream>
+#include <limits>
 #include <string>
+#include <system_error>
 #include <vector>
 
+#include "s21_mapped_file.h"
+#include "s21_snapshot.h"
+
 namespace s21 {
 
 int Graph::GetEdgeWeight(const int &i, const int &j) const {
-  if (i >= Size() && j >= Size()) {
+  if (i < 0 || j < 0 || i >= Size() || j >= Size()) {
     throw "";
   }
-  return adjacency_matrix_.at(i).at(j);
+  auto first = targets_.begin() + offsets_[i];
+  auto last = targets_.begin() + offsets_[i + 1];
+  auto found = std::lower_bound(first, last, j);
+  if (found == last || *found != j) {
+    return 0;
+  }
+  return weights_[found - targets_.begin()];
+}
+
+int Graph::Size() const {
+  return offsets_.empty() ? 0 : static_cast<int>(offsets_.size() - 1);
 }
 
-int Graph::Size() const { return static_cast<int>(adjacency_matrix_.size()); }
+std::size_t Graph::EdgeCount() const { return targets_.size(); }
+
+const LoadStats &Graph::LastLoadStats() const { return load_stats_; }
+
+double LoadStats::MegabytesPerSecond() const {
+  if (seconds <= 0.0) {
+    return 0.0;
+  }
+  return static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds;
+}
 
 bool Graph::IsDirected() const {
   for (int i = 0; i < Size(); ++i) {
-    for (int j = i + 1; j < Size(); ++j) {
-      if (adjacency_matrix_.at(i).at(j) != adjacency_matrix_.at(j).at(i)) {
+    for (std::size_t e = offsets_[i]; e < offsets_[i + 1]; ++e) {
+      if (GetEdgeWeight(targets_[e], i) != weights_[e]) {
         return true;
       }
     }
@@ -30,76 +55,465 @@ bool Graph::IsDirected() const {
   return false;
 }
 
-vector<int> Graph::Neighbors(const int &vertex) const {
-  vector<int> result;
-  for (int i = 0; i < Size(); ++i) {
-    if (adjacency_matrix_.at(vertex).at(i) > 0) {
-      result.push_back(i);
+OutEdgeRange Graph::OutEdges(const int vertex) const {
+  std::size_t first = offsets_[vertex];
+  std::size_t last = offsets_[vertex + 1];
+  return OutEdgeRange(EdgeIterator(targets_.data() + first, weights_.data() + first),
+                      EdgeIterator(targets_.data() + last, weights_.data() + last),
+                      last - first);
+}
+
+ReverseOutEdgeRange Graph::OutEdgesFromEnd(const int vertex) const {
+  OutEdgeRange forward = OutEdges(vertex);
+  return ReverseOutEdgeRange(ReverseEdgeIterator(forward.end()),
+                             ReverseEdgeIterator(forward.begin()),
+                             forward.size());
+}
+
+OutEdgeRange Graph::InEdges(const int vertex) const {
+  std::size_t first = in_offsets_[vertex];
+  std::size_t last = in_offsets_[vertex + 1];
+  return OutEdgeRange(EdgeIterator(sources_.data() + first, in_weights_.data() + first),
+                      EdgeIterator(sources_.data() + last, in_weights_.data() + last),
+                      last - first);
+}
+
+void Graph::BuildReverseIndex() {
+  int size = Size();
+  vector<std::size_t> in_offsets(static_cast<std::size_t>(size) + 1, 0);
+  for (std::size_t e = 0; e < targets_.size(); ++e) {
+    ++in_offsets[targets_[e] + 1];
+  }
+  for (int i = 0; i < size; ++i) {
+    in_offsets[i + 1] += in_offsets[i];
+  }
+  vector<int> sources(targets_.size());
+  vector<int> in_weights(targets_.size());
+  vector<std::size_t> fill(in_offsets.begin(), in_offsets.end() - 1);
+  // Sources are visited in ascending order, so every row ends up sorted.
+  for (int i = 0; i < size; ++i) {
+    for (std::size_t e = offsets_[i]; e < offsets_[i + 1]; ++e) {
+      std::size_t slot = fill[targets_[e]]++;
+      sources[slot] = i;
+      in_weights[slot] = weights_[e];
     }
   }
-  return result;
+  in_offsets_ = std::move(in_offsets);
+  sources_ = std::move(sources);
+  in_weights_ = std::move(in_weights);
+}
+
+vector<int> Graph::Neighbors(const int &vertex) const {
+  return vector<int>(targets_.begin() + offsets_.at(vertex),
+                     targets_.begin() + offsets_.at(vertex + 1));
 }
 
 vector<int> Graph::NeighborsFromEnd(const int &vertex) const {
-  vector<int> result;
-  for (int i = Size() - 1; i >= 0; --i) {
-    if (adjacency_matrix_.at(vertex).at(i) > 0) {
-      result.push_back(i);
+  vector<int> result = Neighbors(vertex);
+  std::reverse(result.begin(), result.end());
+  return result;
+}
+
+namespace {
+
+bool IsBlank(const char symbol) { return symbol == ' ' || symbol == '\t'; }
+
+bool IsLineEnd(const char symbol) { return symbol == '\n' || symbol == '\r'; }
+
+const char *SkipBlanks(const char *pos, const char *end) {
+  while (pos != end && IsBlank(*pos)) {
+    ++pos;
+  }
+  return pos;
+}
+
+// Consumes the rest of the current line, which may hold blanks only.
+const char *FinishLine(const char *pos, const char *end) {
+  pos = SkipBlanks(pos, end);
+  if (pos != end && *pos == '\r') {
+    ++pos;
+  }
+  if (pos != end) {
+    if (*pos != '\n') {
+      throw "loadgraphfromfile: wrong file";
     }
+    ++pos;
   }
-  return result;
+  return pos;
+}
+
+const char *ParseInt(const char *pos, const char *end, int &value) {
+  auto [next, error] = std::from_chars(pos, end, value);
+  if (error != std::errc() ||
+      (next != end && !IsBlank(*next) && !IsLineEnd(*next))) {
+    throw "loadgraphfromfile: wrong file";
+  }
+  return next;
+}
+
+// Reads up to max_count integers from the current line into values and
+// returns how many there were. The position is left at the line end.
+int ParseLine(const char *&pos, const char *end, int *values,
+              const int max_count) {
+  int count = 0;
+  pos = SkipBlanks(pos, end);
+  while (pos != end && !IsLineEnd(*pos)) {
+    if (count == max_count) {
+      throw "loadgraphfromfile: wrong file";
+    }
+    pos = SkipBlanks(ParseInt(pos, end, values[count++]), end);
+  }
+  return count;
+}
+
+const char *SkipLine(const char *pos, const char *end) {
+  while (pos != end && *pos != '\n') {
+    ++pos;
+  }
+  return pos == end ? pos : pos + 1;
+}
+
+bool EndsWith(const std::string &text, const std::string &suffix) {
+  return text.size() >= suffix.size() &&
+         text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+GraphFormat Graph::DetectFormat(const std::string &filename, const char *pos,
+                                const char *end) {
+  if (IsSnapshot(pos, static_cast<std::size_t>(end - pos))) {
+    return GraphFormat::kSnapshot;
+  }
+  if (EndsWith(filename, ".gr")) {
+    return GraphFormat::kDimacs;
+  }
+  if (EndsWith(filename, ".el") || EndsWith(filename, ".edges")) {
+    return GraphFormat::kEdgeList;
+  }
+  while (pos != end) {
+    pos = SkipBlanks(pos, end);
+    if (pos == end || IsLineEnd(*pos)) {
+      pos = SkipLine(pos, end);
+      continue;
+    }
+    if (*pos == 'c' || *pos == 'p') {
+      return GraphFormat::kDimacs;
+    }
+    if (*pos == '#' || *pos == '%') {
+      return GraphFormat::kEdgeList;
+    }
+    int values[3];
+    return ParseLine(pos, end, values, 3) == 1 ? GraphFormat::kMatrix
+                                               : GraphFormat::kEdgeList;
+  }
+  throw "loadgraphfromfile: wrong file";
 }
 
 void Graph::LoadGraphFromFile(std::string filename) {
-  std::ifstream file(filename);
-  if (!file.is_open()) {
+  MappedFile file(filename);
+  GraphFormat format =
+      DetectFormat(filename, file.Data(), file.Data() + file.Size());
+  if (format == GraphFormat::kSnapshot) {
+    LoadBinary(filename);
+  } else {
+    Load(file, format);
+  }
+}
+
+void Graph::LoadGraphFromFile(std::string filename, GraphFormat format) {
+  if (format == GraphFormat::kSnapshot) {
+    LoadBinary(filename);
+    return;
+  }
+  MappedFile file(filename);
+  Load(file, format);
+}
+
+void Graph::Load(const MappedFile &file, GraphFormat format) {
+  auto started = std::chrono::steady_clock::now();
+  file.AdviseSequential();
+  const char *begin = file.Data();
+  const char *end = begin + file.Size();
+  switch (format) {
+  case GraphFormat::kMatrix:
+    LoadMatrix(begin, end);
+    break;
+  case GraphFormat::kEdgeList:
+    LoadEdgeList(begin, end);
+    break;
+  case GraphFormat::kDimacs:
+    LoadDimacs(begin, end);
+    break;
+  case GraphFormat::kSnapshot:
     throw "loadgraphfromfile: wrong file";
   }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - started;
+  load_stats_ = LoadStats{file.Size(), elapsed.count()};
+}
 
-  std::string buff_str;
+void Graph::LoadMatrix(const char *pos, const char *end) {
   int vertex_number = 0;
-  std::getline(file, buff_str);
-  if (sscanf(buff_str.c_str(), "%d", &vertex_number) != 1 ||
-      vertex_number <= 0) {
+  pos = ParseInt(SkipBlanks(pos, end), end, vertex_number);
+  if (vertex_number <= 0) {
     throw "loadgraphfromfile: wrong file";
   }
+  pos = FinishLine(pos, end);
 
-  vector<vector<int>> adjacency_matrix;
-  int buff_val = 0;
-  while (std::getline(file, buff_str)) {
-    CheckLineCorrectness(buff_str);
-    std::istringstream stream(buff_str);
-    std::vector<int> buff_vectr;
-    while (!stream.eof()) {
-      stream >> buff_val;
-      buff_vectr.push_back(buff_val);
+  vector<std::size_t> offsets;
+  vector<int> targets;
+  vector<int> weights;
+  // Every row takes a value and a separator; a header claiming more rows
+  // than the file can hold must not size the reserve.
+  offsets.reserve(std::min(static_cast<std::size_t>(vertex_number),
+                           static_cast<std::size_t>(end - pos) / 2) +
+                  1);
+  offsets.push_back(0);
+  for (int row = 0; row < vertex_number; ++row) {
+    for (int column = 0; column < vertex_number; ++column) {
+      int value = 0;
+      pos = ParseInt(SkipBlanks(pos, end), end, value);
+      if (value > 0) {
+        targets.push_back(column);
+        weights.push_back(value);
+      }
     }
-    adjacency_matrix.push_back(buff_vectr);
+    pos = FinishLine(pos, end);
+    offsets.push_back(targets.size());
+  }
+  while (pos != end) {
+    if (!IsBlank(*pos) && !IsLineEnd(*pos)) {
+      throw "loadgraphfromfile: wrong file";
+    }
+    ++pos;
   }
-  file.close();
 
-  CheckCorrectness(adjacency_matrix, vertex_number);
-  adjacency_matrix_ = adjacency_matrix;
+  offsets_ = std::move(offsets);
+  targets_ = std::move(targets);
+  weights_ = std::move(weights);
+  BuildReverseIndex();
 }
 
-void Graph::CheckCorrectness(vector<vector<int>> &vctr, const int &size) const {
-  std::size_t sz = static_cast<int>(size);
-  if (vctr.size() != sz) {
+void Graph::LoadEdgeList(const char *pos, const char *end) {
+  vector<Arc> arcs;
+  int vertex_number = 0;
+  while (pos != end) {
+    const char *line = SkipBlanks(pos, end);
+    if (line != end && (*line == '#' || *line == '%')) {
+      pos = SkipLine(line, end);
+      continue;
+    }
+    int values[3] = {0, 0, 1};
+    int count = ParseLine(pos, end, values, 3);
+    pos = FinishLine(pos, end);
+    if (count == 0) {
+      continue;
+    }
+    if (count == 1 || values[0] < 0 || values[1] < 0 ||
+        values[0] == std::numeric_limits<int>::max() ||
+        values[1] == std::numeric_limits<int>::max()) {
+      throw "loadgraphfromfile: wrong file";
+    }
+    vertex_number = std::max({vertex_number, values[0] + 1, values[1] + 1});
+    if (values[2] > 0) {
+      arcs.push_back(Arc{values[0], values[1], values[2]});
+    }
+  }
+  if (vertex_number == 0) {
     throw "loadgraphfromfile: wrong file";
   }
-  std::for_each(vctr.begin(), vctr.end(), [sz](const vector<int> &row) {
-    if (row.size() != sz) {
+  AssignArcs(vertex_number, arcs);
+}
+
+void Graph::LoadDimacs(const char *pos, const char *end) {
+  vector<Arc> arcs;
+  int vertex_number = 0;
+  int arc_number = 0;
+  while (pos != end) {
+    pos = SkipBlanks(pos, end);
+    if (pos == end || IsLineEnd(*pos)) {
+      pos = FinishLine(pos, end);
+      continue;
+    }
+    char kind = *pos++;
+    if (kind == 'c') {
+      pos = SkipLine(pos, end);
+    } else if (kind == 'p') {
+      pos = SkipBlanks(pos, end);
+      if (vertex_number != 0 || end - pos < 2 || pos[0] != 's' ||
+          pos[1] != 'p') {
+        throw "loadgraphfromfile: wrong file";
+      }
+      pos += 2;
+      int values[2];
+      if (ParseLine(pos, end, values, 2) != 2 || values[0] <= 0 ||
+          values[1] < 0) {
+        throw "loadgraphfromfile: wrong file";
+      }
+      vertex_number = values[0];
+      arc_number = values[1];
+      // An arc line takes at least six bytes; the final count check
+      // rejects a header claiming more arcs than that.
+      arcs.reserve(std::min(static_cast<std::size_t>(arc_number),
+                            static_cast<std::size_t>(end - pos) / 6));
+      pos = FinishLine(pos, end);
+    } else if (kind == 'a') {
+      int values[3];
+      if (vertex_number == 0 || ParseLine(pos, end, values, 3) != 3 ||
+          values[0] < 1 || values[0] > vertex_number || values[1] < 1 ||
+          values[1] > vertex_number ||
+          static_cast<int>(arcs.size()) == arc_number) {
+        throw "loadgraphfromfile: wrong file";
+      }
+      if (values[2] > 0) {
+        arcs.push_back(Arc{values[0] - 1, values[1] - 1, values[2]});
+      } else {
+        --arc_number;
+      }
+      pos = FinishLine(pos, end);
+    } else {
       throw "loadgraphfromfile: wrong file";
     }
-  });
+  }
+  if (vertex_number == 0 || static_cast<int>(arcs.size()) != arc_number) {
+    throw "loadgraphfromfile: wrong file";
+  }
+  AssignArcs(vertex_number, arcs);
 }
 
-void Graph::CheckLineCorrectness(const std::string &buff_line) const {
-  std::for_each(buff_line.begin(), buff_line.end(), [](const char &a) {
-    if (a != ' ' && a != 9 && a != '-' && (a > 57 || a < 48)) {
-      throw "loadgraphfromfile: wrong file";
+void Graph::AssignArcs(const int vertex_number, vector<Arc> &arcs) {
+  vector<std::size_t> offsets(static_cast<std::size_t>(vertex_number) + 1, 0);
+  for (const Arc &arc : arcs) {
+    ++offsets[arc.from + 1];
+  }
+  for (int i = 0; i < vertex_number; ++i) {
+    offsets[i + 1] += offsets[i];
+  }
+  vector<int> targets(arcs.size());
+  vector<int> weights(arcs.size());
+  vector<std::size_t> fill(offsets.begin(), offsets.end() - 1);
+  for (const Arc &arc : arcs) {
+    std::size_t slot = fill[arc.from]++;
+    targets[slot] = arc.to;
+    weights[slot] = arc.weight;
+  }
+  arcs.clear();
+  arcs.shrink_to_fit();
+
+  // Sort every row by target and keep the lightest of parallel arcs.
+  std::size_t write = 0;
+  vector<Edge> row;
+  for (int i = 0; i < vertex_number; ++i) {
+    row.clear();
+    for (std::size_t e = offsets[i]; e < offsets[i + 1]; ++e) {
+      row.push_back(Edge{targets[e], weights[e]});
     }
-  });
+    std::sort(row.begin(), row.end(), [](const Edge &a, const Edge &b) {
+      return a.to < b.to || (a.to == b.to && a.weight < b.weight);
+    });
+    offsets[i] = write;
+    for (std::size_t k = 0; k < row.size(); ++k) {
+      if (k == 0 || row[k].to != row[k - 1].to) {
+        targets[write] = row[k].to;
+        weights[write] = row[k].weight;
+        ++write;
+      }
+    }
+  }
+  offsets[vertex_number] = write;
+  targets.resize(write);
+  weights.resize(write);
+  targets.shrink_to_fit();
+  weights.shrink_to_fit();
+
+  offsets_ = std::move(offsets);
+  targets_ = std::move(targets);
+  weights_ = std::move(weights);
+  BuildReverseIndex();
+}
+
+namespace {
+
+enum GraphSection : std::uint32_t {
+  kOffsets = 1,
+  kTargets,
+  kWeights,
+  kInOffsets,
+  kSources,
+  kInWeights
+};
+
+// Offsets run from 0 to the edge count without going backwards and every
+// endpoint is a vertex, so edge walks stay inside the arrays. Weights are
+// not read, which keeps loading without the checksum cheap.
+bool IsValidIndex(const SharedArray<std::size_t> &offsets,
+                  const SharedArray<int> &ends, const std::size_t vertices) {
+  if (offsets[0] != 0 || offsets[vertices] != ends.size()) {
+    return false;
+  }
+  for (std::size_t vertex = 0; vertex < vertices; ++vertex) {
+    if (offsets[vertex] > offsets[vertex + 1]) {
+      return false;
+    }
+  }
+  for (int end : ends) {
+    if (end < 0 || static_cast<std::size_t>(end) >= vertices) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+void Graph::SaveBinary(std::string filename) const {
+  static_assert(sizeof(std::size_t) == sizeof(std::uint64_t),
+                "snapshot offsets are 64-bit");
+  SnapshotWriter writer(kGraphSnapshotKind, kGraphSnapshotVersion);
+  writer.SetValue(0, static_cast<std::uint64_t>(Size()));
+  writer.SetValue(1, EdgeCount());
+  writer.AddSection(kOffsets, offsets_.data(), offsets_.size());
+  writer.AddSection(kTargets, targets_.data(), targets_.size());
+  writer.AddSection(kWeights, weights_.data(), weights_.size());
+  writer.AddSection(kInOffsets, in_offsets_.data(), in_offsets_.size());
+  writer.AddSection(kSources, sources_.data(), sources_.size());
+  writer.AddSection(kInWeights, in_weights_.data(), in_weights_.size());
+  writer.Write(filename);
+}
+
+void Graph::LoadBinary(std::string filename, bool verify_checksum) {
+  auto started = std::chrono::steady_clock::now();
+  SnapshotReader reader(filename, kGraphSnapshotKind, kGraphSnapshotVersion,
+                        verify_checksum);
+  std::uint64_t vertex_number = reader.Value(0);
+  std::uint64_t edge_number = reader.Value(1);
+  if (vertex_number == 0 ||
+      vertex_number >
+          static_cast<std::uint64_t>(std::numeric_limits<int>::max()) ||
+      edge_number > reader.Bytes() / sizeof(int)) {
+    throw "loadbinary: wrong file";
+  }
+  auto offsets = reader.Section<std::size_t>(kOffsets, vertex_number + 1);
+  auto targets = reader.Section<int>(kTargets, edge_number);
+  auto weights = reader.Section<int>(kWeights, edge_number);
+  auto in_offsets = reader.Section<std::size_t>(kInOffsets, vertex_number + 1);
+  auto sources = reader.Section<int>(kSources, edge_number);
+  auto in_weights = reader.Section<int>(kInWeights, edge_number);
+  if (!IsValidIndex(offsets, targets, vertex_number) ||
+      !IsValidIndex(in_offsets, sources, vertex_number)) {
+    throw "loadbinary: wrong file";
+  }
+
+  offsets_ = std::move(offsets);
+  targets_ = std::move(targets);
+  weights_ = std::move(weights);
+  in_offsets_ = std::move(in_offsets);
+  sources_ = std::move(sources);
+  in_weights_ = std::move(in_weights);
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - started;
+  load_stats_ = LoadStats{reader.Bytes(), elapsed.count()};
 }
 
 void Graph::ExportGraphToDot(std::string filename) const {
@@ -115,29 +529,28 @@ void Graph::Export(std::ofstream &file, const bool state) const {
   std::string link = (state) ? " -> " : " -- ";
   file << "digraph MyGraph {" << std::endl;
   for (int i = 0; i < Size(); ++i) {
-    for (int j = 0; j < Size(); ++j) {
-      if (adjacency_matrix_.at(i).at(j) > 0) {
-        file << "  " << i << link << j;
-        ExportEdgeWeight(file, i, j);
-      }
+    for (std::size_t e = offsets_[i]; e < offsets_[i + 1]; ++e) {
+      file << "  " << i << link << targets_[e];
+      ExportEdgeWeight(file, weights_[e]);
     }
   }
   file << "}" << std::endl;
 }
 
-void Graph::ExportEdgeWeight(std::ofstream &file, const int &i,
-                             const int &j) const {
-  if (adjacency_matrix_.at(i).at(j) > 0) {
-    file << " .at(label=" << adjacency_matrix_.at(i).at(j)
-         << "; weight=" << adjacency_matrix_.at(i).at(j) << ";)";
-  }
+void Graph::ExportEdgeWeight(std::ofstream &file, const int weight) const {
+  file << " .at(label=" << weight << "; weight=" << weight << ";)";
   file << ";" << std::endl;
 }
 
 void Graph::PrintMatrix() const {
   for (int i = 0; i < Size(); ++i) {
+    std::size_t e = offsets_[i];
     for (int j = 0; j < Size(); ++j) {
-      std::cout << adjacency_matrix_.at(i).at(j) << " ";
+      if (e < offsets_[i + 1] && targets_[e] == j) {
+        std::cout << weights_[e++] << " ";
+      } else {
+        std::cout << 0 << " ";
+      }
     }
     std::cout << std::endl;
   }
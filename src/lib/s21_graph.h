@@ -1,37 +1,177 @@
 #ifndef NAVIGATOR_SRC_LIB_S21_GRAPH_H_
 #define NAVIGATOR_SRC_LIB_S21_GRAPH_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <vector>
 
+#include "s21_shared_array.h"
+
 namespace s21 {
 
 using std::vector;
 
+struct Edge {
+  int to;
+  int weight;
+};
+
+// Walks one CSR row as (neighbor, weight) pairs without allocating.
+class EdgeIterator {
+public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = Edge;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const Edge *;
+  using reference = Edge;
+
+  EdgeIterator() = default;
+  EdgeIterator(const int *target, const int *weight)
+      : target_(target), weight_(weight) {}
+
+  Edge operator*() const { return Edge{*target_, *weight_}; }
+  EdgeIterator &operator++() {
+    ++target_;
+    ++weight_;
+    return *this;
+  }
+  EdgeIterator operator++(int) {
+    EdgeIterator copy = *this;
+    ++*this;
+    return copy;
+  }
+  EdgeIterator &operator--() {
+    --target_;
+    --weight_;
+    return *this;
+  }
+  EdgeIterator operator--(int) {
+    EdgeIterator copy = *this;
+    --*this;
+    return copy;
+  }
+  bool operator==(const EdgeIterator &other) const {
+    return target_ == other.target_;
+  }
+  bool operator!=(const EdgeIterator &other) const {
+    return target_ != other.target_;
+  }
+
+private:
+  const int *target_ = nullptr;
+  const int *weight_ = nullptr;
+};
+
+template <class Iterator> class EdgeRange {
+public:
+  EdgeRange(Iterator first, Iterator last, std::size_t size)
+      : first_(first), last_(last), size_(size) {}
+
+  Iterator begin() const { return first_; }
+  Iterator end() const { return last_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+private:
+  Iterator first_;
+  Iterator last_;
+  std::size_t size_;
+};
+
+using ReverseEdgeIterator = std::reverse_iterator<EdgeIterator>;
+using OutEdgeRange = EdgeRange<EdgeIterator>;
+using ReverseOutEdgeRange = EdgeRange<ReverseEdgeIterator>;
+
+enum class GraphFormat {
+  // "N" on the first line followed by an N x N weight matrix.
+  kMatrix,
+  // One "from to [weight]" arc per line, 0-based ids, '#' or '%' comments.
+  kEdgeList,
+  // DIMACS shortest-path challenge format: "p sp n m" and "a u v w" lines.
+  kDimacs,
+  // Binary file written by Graph::SaveBinary.
+  kSnapshot
+};
+
+// Snapshot kind "GRPH" and the layout version written by SaveBinary.
+const std::uint32_t kGraphSnapshotKind = 0x48505247;
+const std::uint32_t kGraphSnapshotVersion = 2;
+
+// Size and wall time of the most recent load, for throughput tracking.
+struct LoadStats {
+  std::size_t bytes = 0;
+  double seconds = 0.0;
+
+  double MegabytesPerSecond() const;
+};
+
+// Adjacency is kept in compressed sparse row form: the out-edges of vertex v
+// are targets_[offsets_[v] .. offsets_[v + 1]) with matching weights_, sorted
+// by target. Only positive matrix entries are edges. A reverse index groups
+// the same edges by target. The arrays are owned after a text load and views
+// into the mapped file after LoadBinary.
 class Graph {
 public:
   Graph() = default;
 
+  // Parses the file in one pass over a memory mapping. Snapshots are told
+  // apart by their magic; otherwise the format is taken from a .gr / .el /
+  // .edges extension or else from the first line.
   void LoadGraphFromFile(std::string filename);
+  void LoadGraphFromFile(std::string filename, GraphFormat format);
+  const LoadStats &LastLoadStats() const;
+  // Page-aligned, checksummed binary snapshot of the CSR arrays. LoadBinary
+  // maps the file and uses it in place, so startup cost does not depend on
+  // graph size and processes loading the same file share the page cache.
+  // Checksum verification reads the whole file and can be skipped.
+  void SaveBinary(std::string filename) const;
+  void LoadBinary(std::string filename, bool verify_checksum = true);
 
   void ExportGraphToDot(std::string filename) const;
   void PrintMatrix() const;
   int Size() const;
+  std::size_t EdgeCount() const;
   int GetEdgeWeight(const int &i, const int &j) const;
   vector<int> Neighbors(const int &vertex) const;
   vector<int> NeighborsFromEnd(const int &vertex) const;
+  // Out-edges of vertex in ascending / descending neighbor order.
+  OutEdgeRange OutEdges(const int vertex) const;
+  ReverseOutEdgeRange OutEdgesFromEnd(const int vertex) const;
+  // In-edges of vertex in ascending source order; Edge::to is the source.
+  OutEdgeRange InEdges(const int vertex) const;
 
 private:
+  struct Arc {
+    int from;
+    int to;
+    int weight;
+  };
+
+  static GraphFormat DetectFormat(const std::string &filename, const char *pos,
+                                  const char *end);
+  void Load(const MappedFile &file, GraphFormat format);
+  void LoadMatrix(const char *pos, const char *end);
+  void LoadEdgeList(const char *pos, const char *end);
+  void LoadDimacs(const char *pos, const char *end);
+  void AssignArcs(const int vertex_number, vector<Arc> &arcs);
+  void BuildReverseIndex();
   bool IsDirected() const;
-  void ExportEdgeWeight(std::ofstream &file, const int &i, const int &j) const;
+  void ExportEdgeWeight(std::ofstream &file, const int weight) const;
   void Export(std::ofstream &file, const bool direction) const;
-  void CheckCorrectness(vector<vector<int>> &vctr, const int &size) const;
-  void CheckLineCorrectness(const std::string &) const;
 
-  vector<vector<int>> adjacency_matrix_;
+  SharedArray<std::size_t> offsets_;
+  SharedArray<int> targets_;
+  SharedArray<int> weights_;
+  // The same edges grouped by target, for searches that walk edges backwards.
+  SharedArray<std::size_t> in_offsets_;
+  SharedArray<int> sources_;
+  SharedArray<int> in_weights_;
+  LoadStats load_stats_;
 };
 
 } // namespace s21
 
-#endif // NAVIGATOR_SRC_LIB_S21_GRAPH_H_
\ No newline at end of file
+#endif // NAVIGATOR_SRC_LIB_S21_GRAPH_H_
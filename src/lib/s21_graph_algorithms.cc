@@ -1,15 +1,210 @@
 #include "s21_graph_algorithms.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <exception>
 #include <functional>
 #include <numeric>
 #include <random>
 #include <vector>
 
+#include "s21_bit_matrix.h"
+#include "s21_disjoint_set.h"
+#include "s21_distance_matrix.h"
+#include "s21_landmarks.h"
+#include "s21_local_search.h"
+#include "s21_next_hop_matrix.h"
+#include "s21_thread_pool.h"
+
 namespace s21 {
 
+namespace {
+
+// Costs of a Dijkstra edge relaxation and of one level of a heap pop, in
+// blocked Floyd-Warshall min-plus updates (several of which share a SIMD
+// instruction), measured on an optimized build.
+const double kRelaxCost = 15.0;
+const double kHeapLevelCost = 90.0;
+
+// Edges handed to one Boruvka task at a time.
+const std::size_t kBoruvkaChunk = 4096;
+const std::uint64_t kNoEdge = ~std::uint64_t(0);
+
+// Direction switches of the breadth-first tree: go bottom-up once the
+// frontier's out-edges exceed 1 / kBfsAlpha of the unvisited vertices'
+// in-edges, back top-down when fewer than 1 / kBfsBeta of the vertices
+// are on the frontier.
+const std::size_t kBfsAlpha = 14;
+const std::size_t kBfsBeta = 24;
+// Sources of one multi-source BFS, one per bit of a word.
+const std::size_t kBfsBatch = 64;
+
+// Dijkstra state kept between searches. Entries count only when their
+// stamp matches the current generation, so starting a search costs O(1)
+// plus the heap items left over, not O(V).
+class SearchWorkspace {
+public:
+  void Start(const int size) {
+    if (static_cast<int>(stamp_.size()) != size) {
+      distance_.assign(size, kInf);
+      stamp_.assign(size, 0);
+      target_.assign(size, 0);
+      heap_.resize(size);
+      generation_ = 0;
+    }
+    heap_.clear();
+    if (++generation_ == 0) {
+      std::fill(stamp_.begin(), stamp_.end(), 0);
+      std::fill(target_.begin(), target_.end(), 0);
+      generation_ = 1;
+    }
+  }
+
+  int Distance(const int vertex) const {
+    return stamp_[vertex] == generation_ ? distance_[vertex] : kInf;
+  }
+  void SetDistance(const int vertex, const int distance) {
+    stamp_[vertex] = generation_;
+    distance_[vertex] = distance;
+  }
+  // Marks a vertex as wanted by this search; false if it already was.
+  bool AddTarget(const int vertex) {
+    if (target_[vertex] == generation_) {
+      return false;
+    }
+    target_[vertex] = generation_;
+    return true;
+  }
+  // Unmarks a wanted vertex once settled; false if it was not wanted.
+  bool SettleTarget(const int vertex) {
+    if (target_[vertex] != generation_) {
+      return false;
+    }
+    target_[vertex] = 0;
+    return true;
+  }
+  IndexedHeap<int> &Heap() { return heap_; }
+
+private:
+  vector<int> distance_;
+  vector<unsigned> stamp_;
+  vector<unsigned> target_;
+  unsigned generation_ = 0;
+  IndexedHeap<int> heap_;
+};
+
+void AtomicMin(std::atomic<std::uint64_t> &target, const std::uint64_t value) {
+  std::uint64_t current = target.load(std::memory_order_relaxed);
+  while (value < current &&
+         !target.compare_exchange_weak(current, value,
+                                       std::memory_order_relaxed)) {
+  }
+}
+
+// Held-Karp over the subsets of vertices 1 .. n - 1, tours starting at 0:
+// table[set * m + j] is the shortest path that leaves 0, visits set and
+// ends at vertex j + 1. Cost is an unsigned type no tour overflows, so the
+// table stays as narrow as the weights allow.
+template <typename Cost>
+TsmResult HeldKarpTable(const Graph &graph, ThreadPool &pool) {
+  const Cost inf = std::numeric_limits<Cost>::max();
+  const int n = graph.Size();
+  const int m = n - 1;
+  const std::size_t sets = std::size_t(1) << m;
+  vector<Cost> weight(static_cast<std::size_t>(n) * n, inf);
+  for (int vertex = 0; vertex < n; ++vertex) {
+    for (Edge edge : graph.OutEdges(vertex)) {
+      weight[static_cast<std::size_t>(vertex) * n + edge.to] = edge.weight;
+    }
+  }
+  auto arc = [&](const int from, const int to) {
+    return weight[static_cast<std::size_t>(from) * n + to];
+  };
+
+  vector<Cost> table(sets * m, inf);
+  for (int j = 0; j < m; ++j) {
+    table[(std::size_t(1) << j) * m + j] = arc(0, j + 1);
+  }
+  // Sets ordered by size; a layer only reads the one before it, so its
+  // sets are filled concurrently.
+  vector<std::size_t> layer(m + 2, 0);
+  for (std::size_t set = 1; set < sets; ++set) {
+    ++layer[__builtin_popcountll(set) + 1];
+  }
+  std::partial_sum(layer.begin(), layer.end(), layer.begin());
+  vector<std::uint32_t> order(sets);
+  {
+    vector<std::size_t> next(layer.begin(), layer.end() - 1);
+    for (std::size_t set = 1; set < sets; ++set) {
+      order[next[__builtin_popcountll(set)]++] =
+          static_cast<std::uint32_t>(set);
+    }
+  }
+  for (int size = 2; size <= m; ++size) {
+    pool.ParallelFor(
+        layer[size + 1] - layer[size],
+        [&](std::size_t index, int) {
+          std::size_t set = order[layer[size] + index];
+          Cost *row = table.data() + set * m;
+          for (std::size_t rest = set; rest; rest &= rest - 1) {
+            int j = __builtin_ctzll(rest);
+            std::size_t prev = set ^ (std::size_t(1) << j);
+            const Cost *from = table.data() + prev * m;
+            Cost best = inf;
+            for (std::size_t left = prev; left; left &= left - 1) {
+              int k = __builtin_ctzll(left);
+              Cost step = arc(k + 1, j + 1);
+              if (from[k] != inf && step != inf && from[k] + step < best) {
+                best = from[k] + step;
+              }
+            }
+            row[j] = best;
+          }
+        },
+        64);
+  }
+
+  std::size_t set = sets - 1;
+  Cost best = inf;
+  int last = -1;
+  for (int j = 0; j < m; ++j) {
+    Cost back = arc(j + 1, 0);
+    if (table[set * m + j] != inf && back != inf &&
+        table[set * m + j] + back < best) {
+      best = table[set * m + j] + back;
+      last = j;
+    }
+  }
+  TsmResult result{{}, std::numeric_limits<double>::max()};
+  if (last == -1) {
+    return result;
+  }
+  result.distance = static_cast<double>(best);
+  result.vertices.push_back(0);
+  for (int j = last; set;) {
+    result.vertices.push_back(j + 1);
+    std::size_t prev = set ^ (std::size_t(1) << j);
+    for (std::size_t left = prev; left; left &= left - 1) {
+      int k = __builtin_ctzll(left);
+      Cost step = arc(k + 1, j + 1);
+      if (table[prev * m + k] != inf && step != inf &&
+          table[prev * m + k] + step == table[set * m + j]) {
+        j = k;
+        break;
+      }
+    }
+    set = prev;
+  }
+  result.vertices.push_back(0);
+  std::reverse(result.vertices.begin(), result.vertices.end());
+  return result;
+}
+
+} // namespace
+
 vector<int> GraphAlgorithms::DepthFirstSearch(const Graph &graph,
                                               const int start_vertex) {
   if (start_vertex >= graph.Size() || start_vertex < 0) {
@@ -17,7 +212,9 @@ vector<int> GraphAlgorithms::DepthFirstSearch(const Graph &graph,
   }
   vector<bool> visited(graph.Size(), false);
   vector<int> traversed;
+  traversed.reserve(graph.Size());
   Stack<int> vertex_stack;
+  vertex_stack.reserve(graph.Size());
 
   vertex_stack.push(start_vertex);
 
@@ -29,9 +226,9 @@ vector<int> GraphAlgorithms::DepthFirstSearch(const Graph &graph,
       visited.at(vertex) = true;
       traversed.push_back(vertex);
 
-      for (int neighbor : graph.NeighborsFromEnd(vertex)) {
-        if (!visited.at(neighbor)) {
-          vertex_stack.push(neighbor);
+      for (Edge edge : graph.OutEdgesFromEnd(vertex)) {
+        if (!visited.at(edge.to)) {
+          vertex_stack.push(edge.to);
         }
       }
     }
@@ -51,22 +248,24 @@ vector<int> GraphAlgorithms::BreadthFirstSearch(const Graph &graph, int start) {
   }
   vector<bool> visited(graph.Size(), false);
   vector<int> traversed;
+  traversed.reserve(graph.Size());
 
+  // Vertices are marked when queued, so the queue never holds more than
+  // Size() of them; the visiting order is the same as marking on pop.
   Queue<int> vertex_queue;
+  vertex_queue.reserve(graph.Size());
   vertex_queue.push(start);
+  visited[start] = true;
 
   while (!vertex_queue.empty()) {
     int vertex = vertex_queue.front();
     vertex_queue.pop();
+    traversed.push_back(vertex);
 
-    if (!visited.at(vertex)) {
-      visited.at(vertex) = true;
-      traversed.push_back(vertex);
-
-      for (int neighbor : graph.Neighbors(vertex)) {
-        if (!visited.at(neighbor)) {
-          vertex_queue.push(neighbor);
-        }
+    for (Edge edge : graph.OutEdges(vertex)) {
+      if (!visited[edge.to]) {
+        visited[edge.to] = true;
+        vertex_queue.push(edge.to);
       }
     }
   }
@@ -78,6 +277,160 @@ vector<int> GraphAlgorithms::BreadthFirstSearch(const Graph &graph, int start) {
   return traversed;
 }
 
+BfsTree GraphAlgorithms::GetBreadthFirstTree(const Graph &graph,
+                                             const int start) {
+  if (start >= graph.Size() || start < 0) {
+    throw "invalid argument";
+  }
+  const int n = graph.Size();
+  const std::size_t words = (static_cast<std::size_t>(n) + 63) / 64;
+  vector<std::uint64_t> visited(words, 0);
+  vector<std::uint64_t> frontier(words, 0);
+  vector<std::uint64_t> next(words, 0);
+  auto test = [](const vector<std::uint64_t> &bits, const int vertex) {
+    return (bits[vertex >> 6] >> (vertex & 63)) & 1;
+  };
+  auto set = [](vector<std::uint64_t> &bits, const int vertex) {
+    bits[vertex >> 6] |= std::uint64_t(1) << (vertex & 63);
+  };
+
+  BfsTree tree;
+  tree.level.assign(n, -1);
+  tree.parent.assign(n, 0);
+  tree.order.reserve(n);
+  tree.level[start] = 0;
+  tree.order.push_back(start + 1);
+  set(visited, start);
+  set(frontier, start);
+  std::size_t frontier_count = 1;
+  std::size_t frontier_edges = graph.OutEdges(start).size();
+  std::size_t unexplored_edges =
+      graph.EdgeCount() - graph.InEdges(start).size();
+  bool bottom_up = false;
+
+  for (int depth = 1; frontier_count != 0; ++depth) {
+    if (!bottom_up) {
+      bottom_up = frontier_edges * kBfsAlpha > unexplored_edges;
+    } else {
+      bottom_up = frontier_count * kBfsBeta >= static_cast<std::size_t>(n);
+    }
+    std::fill(next.begin(), next.end(), 0);
+    if (bottom_up) {
+      for (std::size_t word = 0; word < words; ++word) {
+        for (std::uint64_t rest = ~visited[word]; rest; rest &= rest - 1) {
+          int vertex = static_cast<int>(word * 64 + __builtin_ctzll(rest));
+          if (vertex >= n) {
+            break;
+          }
+          for (Edge edge : graph.InEdges(vertex)) {
+            if (test(frontier, edge.to)) {
+              tree.parent[vertex] = edge.to + 1;
+              set(next, vertex);
+              break;
+            }
+          }
+        }
+      }
+    } else {
+      for (std::size_t word = 0; word < words; ++word) {
+        for (std::uint64_t rest = frontier[word]; rest; rest &= rest - 1) {
+          int vertex = static_cast<int>(word * 64 + __builtin_ctzll(rest));
+          for (Edge edge : graph.OutEdges(vertex)) {
+            if (!test(visited, edge.to) && !test(next, edge.to)) {
+              tree.parent[edge.to] = vertex + 1;
+              set(next, edge.to);
+            }
+          }
+        }
+      }
+    }
+
+    // Both directions pick the same parents and the level is listed in
+    // ascending order, so the result does not depend on the switches.
+    frontier_count = 0;
+    frontier_edges = 0;
+    for (std::size_t word = 0; word < words; ++word) {
+      visited[word] |= next[word];
+      for (std::uint64_t rest = next[word]; rest; rest &= rest - 1) {
+        int vertex = static_cast<int>(word * 64 + __builtin_ctzll(rest));
+        tree.level[vertex] = depth;
+        tree.order.push_back(vertex + 1);
+        ++frontier_count;
+        frontier_edges += graph.OutEdges(vertex).size();
+        unexplored_edges -= graph.InEdges(vertex).size();
+      }
+    }
+    frontier.swap(next);
+  }
+  return tree;
+}
+
+vector<vector<int>> GraphAlgorithms::GetBreadthFirstLevels(
+    const Graph &graph, const vector<int> &starts, const int threads) {
+  for (int start : starts) {
+    if (start >= graph.Size() || start < 0) {
+      throw "invalid argument";
+    }
+  }
+  vector<vector<int>> levels(starts.size());
+  std::size_t batches = (starts.size() + kBfsBatch - 1) / kBfsBatch;
+  ThreadPool pool(threads);
+  pool.ParallelFor(
+      batches,
+      [&](std::size_t batch, int) {
+        std::size_t first = batch * kBfsBatch;
+        int count = static_cast<int>(
+            std::min(kBfsBatch, starts.size() - first));
+        BreadthFirstBatch(graph, starts.data() + first, count,
+                          levels.data() + first);
+      },
+      1);
+  return levels;
+}
+
+void GraphAlgorithms::BreadthFirstBatch(const Graph &graph, const int *starts,
+                                        const int count, vector<int> *levels) {
+  const int n = graph.Size();
+  // Bit i of a word belongs to starts[i]: seen marks the sources that
+  // reached a vertex, frontier those that reached it on the last level.
+  vector<std::uint64_t> seen(n, 0);
+  vector<std::uint64_t> frontier(n, 0);
+  vector<std::uint64_t> next(n, 0);
+  for (int i = 0; i < count; ++i) {
+    levels[i].assign(n, -1);
+    levels[i][starts[i]] = 0;
+    seen[starts[i]] |= std::uint64_t(1) << i;
+    frontier[starts[i]] |= std::uint64_t(1) << i;
+  }
+
+  for (int depth = 1;; ++depth) {
+    for (int vertex = 0; vertex < n; ++vertex) {
+      std::uint64_t sources = frontier[vertex];
+      if (sources == 0) {
+        continue;
+      }
+      for (Edge edge : graph.OutEdges(vertex)) {
+        std::uint64_t reached = sources & ~seen[edge.to];
+        seen[edge.to] |= reached;
+        next[edge.to] |= reached;
+      }
+    }
+    bool active = false;
+    for (int vertex = 0; vertex < n; ++vertex) {
+      for (std::uint64_t reached = next[vertex]; reached;
+           reached &= reached - 1) {
+        levels[__builtin_ctzll(reached)][vertex] = depth;
+        active = true;
+      }
+    }
+    if (!active) {
+      break;
+    }
+    frontier.swap(next);
+    std::fill(next.begin(), next.end(), 0);
+  }
+}
+
 int GraphAlgorithms::GetShortestPathBetweenVertices(const Graph &graph,
                                                     const int vertex1,
                                                     const int vertex2) {
@@ -85,60 +438,342 @@ int GraphAlgorithms::GetShortestPathBetweenVertices(const Graph &graph,
       vertex2 > graph.Size()) {
     throw "";
   }
+  int target = vertex2 - 1;
   vector<int> distance(graph.Size(), kInf);
-  vector<bool> visited(graph.Size(), false);
-  Queue<int> vertex_queue;
+  IndexedHeap<int> heap(graph.Size());
 
   distance.at(vertex1 - 1) = 0;
-  vertex_queue.push(vertex1 - 1);
+  heap.push(vertex1 - 1, 0);
 
-  while (!vertex_queue.empty()) {
-    int i = vertex_queue.front();
-    vertex_queue.pop();
+  // Weights are positive, so a popped vertex is settled and the search can
+  // stop as soon as the target leaves the heap.
+  while (!heap.empty()) {
+    int i = heap.top();
+    heap.pop();
+    if (i == target) {
+      break;
+    }
 
-    if (visited.at(i)) {
-      continue;
+    for (Edge edge : graph.OutEdges(i)) {
+      int new_distance = distance[i] + edge.weight;
+      if (new_distance < distance[edge.to]) {
+        distance[edge.to] = new_distance;
+        heap.push_or_decrease(edge.to, new_distance);
+      }
     }
-    visited.at(i) = true;
+  }
+  return distance.at(target);
+}
+
+int ShortestPathTree::Distance(const int vertex) const {
+  if (vertex < 1 || vertex > Size()) {
+    throw "";
+  }
+  return distance_[vertex - 1];
+}
+
+int ShortestPathTree::Predecessor(const int vertex) const {
+  if (vertex < 1 || vertex > Size()) {
+    throw "";
+  }
+  return predecessor_[vertex - 1] + 1;
+}
+
+ShortestPath ShortestPathTree::Path(const int vertex) const {
+  ShortestPath path{Distance(vertex), {}};
+  if (path.distance == kInf) {
+    return path;
+  }
+  for (int current = vertex - 1; current != -1;
+       current = predecessor_[current]) {
+    path.vertices.push_back(current + 1);
+  }
+  std::reverse(path.vertices.begin(), path.vertices.end());
+  return path;
+}
+
+ShortestPathTree GraphAlgorithms::GetShortestPathTree(const Graph &graph,
+                                                      const int source) {
+  if (source < 1 || source > graph.Size()) {
+    throw "";
+  }
+  ShortestPathTree tree;
+  tree.source_ = source - 1;
+  tree.distance_.assign(graph.Size(), kInf);
+  tree.predecessor_.assign(graph.Size(), -1);
+  IndexedHeap<int> heap(graph.Size());
 
-    for (int j : graph.Neighbors(i)) {
-      int new_distance = distance.at(i) + graph.GetEdgeWeight(i, j);
-      if (new_distance < distance.at(j)) {
-        distance.at(j) = new_distance;
-        vertex_queue.push(j);
+  tree.distance_[source - 1] = 0;
+  heap.push(source - 1, 0);
+  while (!heap.empty()) {
+    int vertex = heap.top();
+    int distance = heap.top_key();
+    heap.pop();
+    for (Edge edge : graph.OutEdges(vertex)) {
+      int new_distance = distance + edge.weight;
+      if (new_distance < tree.distance_[edge.to]) {
+        tree.distance_[edge.to] = new_distance;
+        tree.predecessor_[edge.to] = vertex;
+        heap.push_or_decrease(edge.to, new_distance);
       }
     }
   }
-  return distance.at(vertex2 - 1);
+  return tree;
 }
 
-vector<vector<int>>
-GraphAlgorithms::GetShortestPathsBetweenAllVertices(const Graph &graph) {
-  int count = graph.Size();
-  vector<vector<int>> distances(count, vector<int>(count, kInf));
+vector<int> GraphAlgorithms::GetShortestPathsBetweenPairs(
+    const Graph &graph, const vector<PathQuery> &queries, const int threads) {
+  for (const PathQuery &query : queries) {
+    if (query.source < 1 || query.source > graph.Size() || query.target < 1 ||
+        query.target > graph.Size()) {
+      throw "";
+    }
+  }
+  vector<int> order(queries.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&queries](int a, int b) {
+    return queries[a].source < queries[b].source ||
+           (queries[a].source == queries[b].source && a < b);
+  });
+  // order[groups[g] .. groups[g + 1]) are the queries of one source.
+  vector<std::size_t> groups;
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    if (i == 0 || queries[order[i]].source != queries[order[i - 1]].source) {
+      groups.push_back(i);
+    }
+  }
+  groups.push_back(order.size());
 
-  for (int i = 0; i < count; ++i) {
-    for (int j = 0; j < count; ++j) {
-      if (graph.GetEdgeWeight(i, j) > 0) {
-        distances.at(i).at(j) = graph.GetEdgeWeight(i, j);
+  vector<int> distances(queries.size(), kInf);
+  ThreadPool pool(threads);
+  vector<SearchWorkspace> workspaces(pool.Size());
+  pool.ParallelFor(groups.size() - 1, [&](std::size_t group, int worker) {
+    SearchWorkspace &workspace = workspaces[worker];
+    workspace.Start(graph.Size());
+    IndexedHeap<int> &heap = workspace.Heap();
+    int remaining = 0;
+    for (std::size_t i = groups[group]; i < groups[group + 1]; ++i) {
+      remaining += workspace.AddTarget(queries[order[i]].target - 1);
+    }
+    int source = queries[order[groups[group]]].source - 1;
+    workspace.SetDistance(source, 0);
+    heap.push(source, 0);
+    while (!heap.empty()) {
+      int vertex = heap.top();
+      int distance = heap.top_key();
+      heap.pop();
+      if (workspace.SettleTarget(vertex) && --remaining == 0) {
+        break;
+      }
+      for (Edge edge : graph.OutEdges(vertex)) {
+        int new_distance = distance + edge.weight;
+        if (new_distance < workspace.Distance(edge.to)) {
+          workspace.SetDistance(edge.to, new_distance);
+          heap.push_or_decrease(edge.to, new_distance);
+        }
       }
     }
+    for (std::size_t i = groups[group]; i < groups[group + 1]; ++i) {
+      distances[order[i]] = workspace.Distance(queries[order[i]].target - 1);
+    }
+  });
+  return distances;
+}
+
+int GraphAlgorithms::GetShortestPathBetweenVertices(const Graph &graph,
+                                                    const int vertex1,
+                                                    const int vertex2,
+                                                    const SearchMode mode) {
+  if (mode == SearchMode::kUnidirectional) {
+    return GetShortestPathBetweenVertices(graph, vertex1, vertex2);
+  }
+  if (vertex1 < 1 || vertex1 > graph.Size() || vertex2 < 1 ||
+      vertex2 > graph.Size()) {
+    throw "";
+  }
+  return BidirectionalDijkstra(graph, vertex1 - 1, vertex2 - 1);
+}
+
+int GraphAlgorithms::BidirectionalDijkstra(const Graph &graph,
+                                           const int source,
+                                           const int target) {
+  if (source == target) {
+    return 0;
   }
+  // Side 0 searches forward from the source, side 1 backward from the target.
+  vector<int> distance[2] = {vector<int>(graph.Size(), kInf),
+                             vector<int>(graph.Size(), kInf)};
+  IndexedHeap<int> heap[2] = {IndexedHeap<int>(graph.Size()),
+                              IndexedHeap<int>(graph.Size())};
+  distance[0][source] = 0;
+  distance[1][target] = 0;
+  heap[0].push(source, 0);
+  heap[1].push(target, 0);
+  long long best = kInf;
 
-  for (int k = 0; k < count; ++k) {
-    for (int i = 0; i < count; ++i) {
-      for (int j = 0; j < count; ++j) {
-        if (distances.at(i).at(k) != kInf && distances.at(k).at(j) != kInf) {
-          distances.at(i).at(j) =
-              std::min(distances.at(i).at(j), distances.at(i).at(k) + distances.at(k).at(j));
+  // Once the two frontier keys add up to the best meeting distance, no
+  // unsettled vertex can lie on a shorter path.
+  while (!heap[0].empty() && !heap[1].empty() &&
+         static_cast<long long>(heap[0].top_key()) + heap[1].top_key() <
+             best) {
+    int side = heap[0].top_key() <= heap[1].top_key() ? 0 : 1;
+    int vertex = heap[side].top();
+    heap[side].pop();
+    auto edges = side == 0 ? graph.OutEdges(vertex) : graph.InEdges(vertex);
+    for (Edge edge : edges) {
+      int new_distance = distance[side][vertex] + edge.weight;
+      if (new_distance < distance[side][edge.to]) {
+        distance[side][edge.to] = new_distance;
+        heap[side].push_or_decrease(edge.to, new_distance);
+      }
+      if (distance[1 - side][edge.to] != kInf) {
+        best = std::min(best, static_cast<long long>(new_distance) +
+                                  distance[1 - side][edge.to]);
+      }
+    }
+  }
+  return best >= kInf ? kInf : static_cast<int>(best);
+}
+
+int GraphAlgorithms::GetShortestPathBetweenVertices(const Graph &graph,
+                                                    const Landmarks &landmarks,
+                                                    const int vertex1,
+                                                    const int vertex2) {
+  if (vertex1 < 1 || vertex1 > graph.Size() || vertex2 < 1 ||
+      vertex2 > graph.Size() || landmarks.Size() != graph.Size()) {
+    throw "";
+  }
+  int target = vertex2 - 1;
+  vector<int> distance(graph.Size(), kInf);
+  // Lower bounds are computed on first touch; -1 marks "not yet".
+  vector<int> bound(graph.Size(), -1);
+  IndexedHeap<int> heap(graph.Size());
+
+  distance.at(vertex1 - 1) = 0;
+  heap.push(vertex1 - 1, landmarks.LowerBound(vertex1 - 1, target));
+
+  // ALT bounds are consistent, so the target is settled when popped.
+  while (!heap.empty()) {
+    int i = heap.top();
+    heap.pop();
+    if (i == target) {
+      break;
+    }
+
+    for (Edge edge : graph.OutEdges(i)) {
+      int new_distance = distance[i] + edge.weight;
+      if (new_distance < distance[edge.to]) {
+        distance[edge.to] = new_distance;
+        if (bound[edge.to] < 0) {
+          bound[edge.to] = landmarks.LowerBound(edge.to, target);
         }
+        heap.push_or_decrease(edge.to, new_distance + bound[edge.to]);
       }
     }
   }
+  return distance.at(target);
+}
 
+vector<vector<int>>
+GraphAlgorithms::GetShortestPathsBetweenAllVertices(const Graph &graph) {
+  DistanceMatrix distances = DistanceMatrix::FromGraph(graph);
+  distances.FloydWarshall();
+  return distances.ToVectors();
+}
+
+vector<vector<int>> GraphAlgorithms::GetShortestPathsBetweenAllVertices(
+    const Graph &graph, const int threads, const AllPairsMethod method) {
+  ThreadPool pool(threads);
+  return AllPairs(graph, pool, method).ToVectors();
+}
+
+vector<vector<int>> GraphAlgorithms::GetShortestPathsBetweenAllVertices(
+    const Graph &graph, const int threads, const AllPairsMethod method,
+    NextHopMatrix &next_hops) {
+  ThreadPool pool(threads);
+  DistanceMatrix distances = AllPairs(graph, pool, method);
+  next_hops = NextHopMatrix::Build(graph, distances, pool);
+  return distances.ToVectors();
+}
+
+DistanceMatrix GraphAlgorithms::AllPairs(const Graph &graph, ThreadPool &pool,
+                                         const AllPairsMethod method) {
+  DistanceMatrix distances(graph.Size());
+  AllPairsMethod chosen = method == AllPairsMethod::kAuto
+                              ? ChooseAllPairsMethod(graph, pool.Size())
+                              : method;
+  if (chosen == AllPairsMethod::kJohnson) {
+    Johnson(graph, pool, distances);
+  } else {
+    distances = DistanceMatrix::FromGraph(graph);
+    distances.FloydWarshall(pool);
+  }
   return distances;
 }
 
+BitMatrix GraphAlgorithms::GetTransitiveClosure(const Graph &graph,
+                                                const int threads) {
+  BitMatrix reach = BitMatrix::FromGraph(graph);
+  ThreadPool pool(threads);
+  reach.TransitiveClosure(pool);
+  return reach;
+}
+
+AllPairsMethod GraphAlgorithms::ChooseAllPairsMethod(const Graph &graph,
+                                                     const int threads) {
+  double size = graph.Size();
+  double workers = threads > 0 ? threads : ThreadPool::HardwareThreads();
+  // Johnson's rows are all independent; a Floyd-Warshall round only has
+  // the tiles off the pivot block row and column to share out.
+  double johnson = size *
+                   (graph.EdgeCount() * kRelaxCost +
+                    size * std::log2(size + 1) * kHeapLevelCost) /
+                   std::min(workers, std::max(size, 1.0));
+  double blocks = std::ceil(size / DistanceMatrix::kBlock);
+  double padded = blocks * DistanceMatrix::kBlock;
+  double floyd = padded * padded * padded /
+                 std::min(workers, std::max((blocks - 1) * (blocks - 1), 1.0));
+  return johnson < floyd ? AllPairsMethod::kJohnson
+                         : AllPairsMethod::kFloydWarshall;
+}
+
+void GraphAlgorithms::Johnson(const Graph &graph, ThreadPool &pool,
+                              DistanceMatrix &distances) {
+  // Loaders keep only positive weights, so the Bellman-Ford potentials of
+  // Johnson's reweighting step are all zero and it is left out.
+  int size = graph.Size();
+  vector<IndexedHeap<int>> heaps(pool.Size(), IndexedHeap<int>(size));
+  pool.ParallelFor(
+      size,
+      [&](std::size_t index, int worker) {
+        int source = static_cast<int>(index);
+        int *distance = distances.Row(source);
+        IndexedHeap<int> &heap = heaps[worker];
+        distance[source] = 0;
+        heap.push(source, 0);
+        while (!heap.empty()) {
+          int i = heap.top();
+          heap.pop();
+          for (Edge edge : graph.OutEdges(i)) {
+            int new_distance = distance[i] + edge.weight;
+            if (new_distance < distance[edge.to]) {
+              distance[edge.to] = new_distance;
+              heap.push_or_decrease(edge.to, new_distance);
+            }
+          }
+        }
+        // Like Floyd-Warshall, report the shortest cycle through the
+        // source rather than 0.
+        long long cycle = kInf;
+        for (Edge edge : graph.InEdges(source)) {
+          cycle = std::min(cycle, static_cast<long long>(distance[edge.to]) +
+                                      edge.weight);
+        }
+        distance[source] = static_cast<int>(cycle);
+      },
+      4);
+}
+
 vector<vector<int>> GraphAlgorithms::GetLeastSpanningTree(const Graph &graph) {
   int size = graph.Size();
   vector<bool> visited(size, false);
@@ -164,16 +799,15 @@ vector<vector<int>> GraphAlgorithms::GetLeastSpanningTree(const Graph &graph) {
 
     if (parents.at(min_vertex) != -1) {
       spanning_tree.at(parents.at(min_vertex)).at(min_vertex) =
-          graph.GetEdgeWeight(parents.at(min_vertex), min_vertex);
+          distances.at(min_vertex);
       spanning_tree.at(min_vertex).at(parents.at(min_vertex)) =
-          graph.GetEdgeWeight(parents.at(min_vertex), min_vertex);
+          distances.at(min_vertex);
     }
 
-    for (int j = 0; j < size; ++j) {
-      if (!visited.at(j) && graph.GetEdgeWeight(min_vertex, j) > 0 &&
-          graph.GetEdgeWeight(min_vertex, j) < distances.at(j)) {
-        parents.at(j) = min_vertex;
-        distances.at(j) = graph.GetEdgeWeight(min_vertex, j);
+    for (Edge edge : graph.OutEdges(min_vertex)) {
+      if (!visited.at(edge.to) && edge.weight < distances.at(edge.to)) {
+        parents.at(edge.to) = min_vertex;
+        distances.at(edge.to) = edge.weight;
       }
     }
   }
@@ -181,74 +815,315 @@ vector<vector<int>> GraphAlgorithms::GetLeastSpanningTree(const Graph &graph) {
   return spanning_tree;
 }
 
-vector<vector<double>> GraphAlgorithms::InitializePheromone(int n) {
-  if (n < 1) {
-    throw "";
+SpanningForest
+GraphAlgorithms::GetMinimumSpanningForest(const Graph &graph,
+                                          const SpanningTreeMethod method,
+                                          const int threads) {
+  SpanningForest forest;
+  if (method == SpanningTreeMethod::kPrim) {
+    forest = PrimForest(graph);
+  } else if (method == SpanningTreeMethod::kKruskal) {
+    forest = KruskalForest(graph);
+  } else {
+    ThreadPool pool(threads);
+    forest = BoruvkaForest(graph, pool);
+  }
+  for (TreeEdge &edge : forest.edges) {
+    ++edge.from;
+    ++edge.to;
+    forest.weight += edge.weight;
+  }
+  return forest;
+}
+
+SpanningForest GraphAlgorithms::PrimForest(const Graph &graph) {
+  int size = graph.Size();
+  vector<char> in_tree(size, 0);
+  vector<int> weight(size, kInf);
+  vector<int> parent(size, -1);
+  IndexedHeap<int> heap(size);
+  SpanningForest forest;
+
+  for (int root = 0; root < size; ++root) {
+    if (in_tree[root]) {
+      continue;
+    }
+    heap.push(root, 0);
+    while (!heap.empty()) {
+      int vertex = heap.top();
+      heap.pop();
+      in_tree[vertex] = 1;
+      if (parent[vertex] != -1) {
+        forest.edges.push_back(
+            TreeEdge{parent[vertex], vertex, weight[vertex]});
+      }
+      auto relax = [&](const Edge &edge) {
+        if (!in_tree[edge.to] && edge.weight < weight[edge.to]) {
+          weight[edge.to] = edge.weight;
+          parent[edge.to] = vertex;
+          heap.push_or_decrease(edge.to, edge.weight);
+        }
+      };
+      for (Edge edge : graph.OutEdges(vertex)) {
+        relax(edge);
+      }
+      for (Edge edge : graph.InEdges(vertex)) {
+        relax(edge);
+      }
+    }
+  }
+  return forest;
+}
+
+SpanningForest GraphAlgorithms::KruskalForest(const Graph &graph) {
+  int size = graph.Size();
+  vector<TreeEdge> arcs;
+  arcs.reserve(graph.EdgeCount());
+  for (int vertex = 0; vertex < size; ++vertex) {
+    for (Edge edge : graph.OutEdges(vertex)) {
+      if (edge.to != vertex) {
+        arcs.push_back(TreeEdge{vertex, edge.to, edge.weight});
+      }
+    }
+  }
+  std::sort(arcs.begin(), arcs.end(),
+            [](const TreeEdge &a, const TreeEdge &b) {
+              return a.weight < b.weight;
+            });
+
+  DisjointSet components(size);
+  SpanningForest forest;
+  for (const TreeEdge &arc : arcs) {
+    if (components.Count() == 1) {
+      break;
+    }
+    if (components.Unite(arc.from, arc.to)) {
+      forest.edges.push_back(arc);
+    }
+  }
+  return forest;
+}
+
+SpanningForest GraphAlgorithms::BoruvkaForest(const Graph &graph,
+                                              ThreadPool &pool) {
+  int size = graph.Size();
+  vector<TreeEdge> arcs;
+  arcs.reserve(graph.EdgeCount());
+  for (int vertex = 0; vertex < size; ++vertex) {
+    for (Edge edge : graph.OutEdges(vertex)) {
+      if (edge.to != vertex) {
+        arcs.push_back(TreeEdge{vertex, edge.to, edge.weight});
+      }
+    }
+  }
+
+  // Edges between components, by the components' root vertices. Keys pack
+  // (weight, arc index) so every edge compares differently and the
+  // cheapest edges of one round can never close a cycle.
+  struct Contracted {
+    int from;
+    int to;
+    std::uint32_t arc;
+  };
+  vector<Contracted> edges(arcs.size());
+  for (std::size_t i = 0; i < arcs.size(); ++i) {
+    edges[i] = Contracted{arcs[i].from, arcs[i].to,
+                          static_cast<std::uint32_t>(i)};
+  }
+  vector<int> active(size);
+  std::iota(active.begin(), active.end(), 0);
+  vector<std::atomic<std::uint64_t>> cheapest(size);
+  ConcurrentDisjointSet components(size);
+  vector<vector<std::uint32_t>> taken(pool.Size());
+  auto chunks = [](const std::size_t count) {
+    return (count + kBoruvkaChunk - 1) / kBoruvkaChunk;
+  };
+
+  while (!edges.empty()) {
+    pool.ParallelFor(
+        active.size(),
+        [&](std::size_t i, int) { cheapest[active[i]].store(kNoEdge); },
+        kBoruvkaChunk);
+    pool.ParallelFor(chunks(edges.size()), [&](std::size_t chunk, int) {
+      std::size_t last = std::min(edges.size(), (chunk + 1) * kBoruvkaChunk);
+      for (std::size_t e = chunk * kBoruvkaChunk; e < last; ++e) {
+        std::uint64_t key =
+            static_cast<std::uint64_t>(arcs[edges[e].arc].weight) << 32 |
+            edges[e].arc;
+        AtomicMin(cheapest[edges[e].from], key);
+        AtomicMin(cheapest[edges[e].to], key);
+      }
+    });
+    // When two components pick the same edge only one Unite succeeds.
+    pool.ParallelFor(
+        active.size(),
+        [&](std::size_t i, int worker) {
+          std::uint64_t key = cheapest[active[i]].load();
+          if (key == kNoEdge) {
+            return;
+          }
+          std::uint32_t arc = static_cast<std::uint32_t>(key);
+          if (components.Unite(arcs[arc].from, arcs[arc].to)) {
+            taken[worker].push_back(arc);
+          }
+        },
+        256);
+
+    // Contract: relabel endpoints with their new roots and drop the edges
+    // that now lie inside one component.
+    vector<std::size_t> kept(chunks(edges.size()) + 1, 0);
+    pool.ParallelFor(chunks(edges.size()), [&](std::size_t chunk, int) {
+      std::size_t last = std::min(edges.size(), (chunk + 1) * kBoruvkaChunk);
+      for (std::size_t e = chunk * kBoruvkaChunk; e < last; ++e) {
+        edges[e].from = components.Find(edges[e].from);
+        edges[e].to = components.Find(edges[e].to);
+        kept[chunk + 1] += edges[e].from != edges[e].to;
+      }
+    });
+    std::partial_sum(kept.begin(), kept.end(), kept.begin());
+    vector<Contracted> next(kept.back());
+    pool.ParallelFor(chunks(edges.size()), [&](std::size_t chunk, int) {
+      std::size_t last = std::min(edges.size(), (chunk + 1) * kBoruvkaChunk);
+      std::size_t write = kept[chunk];
+      for (std::size_t e = chunk * kBoruvkaChunk; e < last; ++e) {
+        if (edges[e].from != edges[e].to) {
+          next[write++] = edges[e];
+        }
+      }
+    });
+    edges.swap(next);
+    active.erase(std::remove_if(active.begin(), active.end(),
+                                [&components](const int vertex) {
+                                  return components.Find(vertex) != vertex;
+                                }),
+                 active.end());
   }
-  return vector<vector<double>>(n, vector<double>(n, kInitialPheromone));
+
+  vector<std::uint32_t> forest_arcs;
+  for (const vector<std::uint32_t> &list : taken) {
+    forest_arcs.insert(forest_arcs.end(), list.begin(), list.end());
+  }
+  std::sort(forest_arcs.begin(), forest_arcs.end());
+  SpanningForest forest;
+  for (std::uint32_t arc : forest_arcs) {
+    forest.edges.push_back(arcs[arc]);
+  }
+  return forest;
 }
 
-double GraphAlgorithms::Eta(int i, int j, const Graph &graph) {
-  return 1.0 / (graph.GetEdgeWeight(i, j));
+double GraphAlgorithms::Eta(const int weight) { return 1.0 / weight; }
+
+GraphAlgorithms::Colony
+GraphAlgorithms::InitializeColony(const Graph &graph,
+                                  const TsmOptions &options) {
+  int n = graph.Size();
+  if (n < 1) {
+    throw "";
+  }
+  Colony colony;
+  colony.size = n;
+  colony.alpha = options.alpha;
+  colony.beta = options.beta;
+  colony.rho = options.rho;
+  colony.pheromone.assign(static_cast<std::size_t>(n) * n, kInitialPheromone);
+  colony.choice.assign(colony.pheromone.size(), 0.0);
+  colony.candidates = NearestNeighbors(graph, kNumCandidates);
+  return colony;
 }
 
-double GraphAlgorithms::Random() {
-  std::random_device rd;
-  std::default_random_engine engine(rd());
-  auto gen = std::bind(std::uniform_real_distribution<>(0, 1), engine);
-  return static_cast<double>(gen());
+void GraphAlgorithms::UpdateChoiceInfo(Colony &colony, const Graph &graph,
+                                       ThreadPool &pool) {
+  int n = colony.size;
+  pool.ParallelFor(
+      n,
+      [&](std::size_t vertex, int) {
+        std::size_t row = vertex * n;
+        for (Edge edge : graph.OutEdges(static_cast<int>(vertex))) {
+          colony.choice[row + edge.to] =
+              pow(colony.pheromone[row + edge.to], colony.alpha) *
+              pow(Eta(edge.weight), colony.beta);
+        }
+      },
+      16);
 }
 
 int GraphAlgorithms::SelectNext(const int current, const vector<bool> &visited,
-                                const vector<vector<double>> &pheromone,
-                                const Graph &graph) {
-  int answ = -1;
-  double answ_attractivness = 0.0;
-  int size = visited.size();
+                                const Colony &colony, const Graph &graph,
+                                Xoshiro256 &random) {
+  // Roulette wheel: each unvisited neighbor is taken with probability
+  // proportional to its attractiveness. Only the candidate list is tried
+  // unless all of it has been visited.
+  const double *choice =
+      colony.choice.data() + static_cast<std::size_t>(current) * colony.size;
+  const int *candidates = colony.candidates.data() +
+                          static_cast<std::size_t>(current) * kNumCandidates;
   double sum = 0.0;
-  for (int i = 0; i < size; ++i) {
-    if (visited.at(i) == false && (graph.GetEdgeWeight(current, i) > 0)) {
-      sum += pow(pheromone.at(current).at(i), kAlpha) *
-             pow(Eta(current, i, graph), kBeta);
+  int answ = -1;
+  for (int i = 0; i < kNumCandidates && candidates[i] != -1; ++i) {
+    if (!visited[candidates[i]]) {
+      sum += choice[candidates[i]];
+      answ = candidates[i];
     }
   }
+  if (answ != -1) {
+    double point = random.NextDouble() * sum;
+    for (int i = 0; i < kNumCandidates && candidates[i] != -1; ++i) {
+      if (!visited[candidates[i]]) {
+        answ = candidates[i];
+        point -= choice[candidates[i]];
+        if (point < 0.0) {
+          break;
+        }
+      }
+    }
+    return answ;
+  }
 
-  double buff_attractivness = 0.0;
-  for (int i = 0; i < size; ++i) {
-    if (visited.at(i) == false && (graph.GetEdgeWeight(current, i) > 0)) {
-      buff_attractivness = pow(pheromone.at(current).at(i), kAlpha) *
-                           pow(Eta(current, i, graph), kBeta) / sum;
-      if (buff_attractivness > answ_attractivness) {
-        answ = i;
-        answ_attractivness = buff_attractivness;
+  for (Edge edge : graph.OutEdges(current)) {
+    if (!visited[edge.to]) {
+      sum += choice[edge.to];
+      answ = edge.to;
+    }
+  }
+  if (answ == -1) {
+    return -1;
+  }
+  double point = random.NextDouble() * sum;
+  for (Edge edge : graph.OutEdges(current)) {
+    if (!visited[edge.to]) {
+      answ = edge.to;
+      point -= choice[edge.to];
+      if (point < 0.0) {
+        break;
       }
     }
   }
   return answ;
 }
 
-void GraphAlgorithms::UpdatePheromone(vector<vector<double>> &pheromone,
-                                      const vector<Ant> &ants,
-                                      const Graph &graph) {
-  for (auto &start : pheromone) {
-    for (auto &road : start) {
-      road *= kRHO;
-    }
+void GraphAlgorithms::UpdatePheromone(Colony &colony,
+                                      const vector<Ant> &ants) {
+  for (double &trail : colony.pheromone) {
+    trail *= 1.0 - colony.rho;
   }
-
-  for (auto &ant : ants) {
-    for (auto itr = ant.ant_result_.vertices.begin();
-         itr != ant.ant_result_.vertices.end() - 1; ++itr) {
-      int start = *itr;
-      int end = *(itr + 1);
-      pheromone.at(start).at(end) += ant.quantity_ / graph.GetEdgeWeight(start, end);
+  // Ants deposit in index order, so the trails do not depend on how they
+  // were split between workers.
+  int n = colony.size;
+  for (const Ant &ant : ants) {
+    const vector<int> &tour = ant.ant_result_.vertices;
+    if (static_cast<int>(tour.size()) != n + 1) {
+      continue;
+    }
+    for (int i = 0; i < n; ++i) {
+      colony.pheromone[static_cast<std::size_t>(tour[i]) * n + tour[i + 1]] +=
+          ant.quantity_;
     }
   }
 }
 
 Ant GraphAlgorithms::BuildTour(int start, vector<bool> &visited,
-                               const vector<vector<double>> &pheromone,
-                               const Graph &graph) {
+                               const Colony &colony, const Graph &graph,
+                               Xoshiro256 &random) {
   Ant ant;
   ant.ant_result_.vertices.push_back(start);
   ant.ant_result_.distance = 0.0;
@@ -257,13 +1132,12 @@ Ant GraphAlgorithms::BuildTour(int start, vector<bool> &visited,
   int size = visited.size();
   for (int i = 1; i < size; ++i) {
     int next = -1;
-    next = SelectNext(current, visited, pheromone, graph);
+    next = SelectNext(current, visited, colony, graph, random);
     if (next == -1) {
       break;
     }
     ant.ant_result_.vertices.push_back(next);
     ant.ant_result_.distance += graph.GetEdgeWeight(current, next);
-    ant.quantity_ += pheromone.at(current).at(next);
     visited.at(next) = true;
     current = next;
   }
@@ -271,43 +1145,141 @@ Ant GraphAlgorithms::BuildTour(int start, vector<bool> &visited,
   if (graph.GetEdgeWeight(current, start) > 0) {
     ant.ant_result_.vertices.push_back(start);
     ant.ant_result_.distance += graph.GetEdgeWeight(current, start);
-    ant.quantity_ += pheromone.at(current).at(start);
   }
+  ant.quantity_ = kQ / ant.ant_result_.distance;
 
   return ant;
 }
 
+TsmResult GraphAlgorithms::ImproveTour(const Graph &graph,
+                                       const TsmResult &tour) {
+  TsmResult result = tour;
+  for (int &vertex : result.vertices) {
+    --vertex;
+  }
+  result.distance = LocalSearch(graph).Improve(result.vertices);
+  for (int &vertex : result.vertices) {
+    ++vertex;
+  }
+  return result;
+}
+
+TsmResult GraphAlgorithms::HeldKarp(const Graph &graph, ThreadPool &pool) {
+  int n = graph.Size();
+  if (n == 1) {
+    return TsmResult{{0, 0}, 0.0};
+  }
+  long long heaviest = 0;
+  for (int vertex = 0; vertex < n; ++vertex) {
+    for (Edge edge : graph.OutEdges(vertex)) {
+      heaviest = std::max<long long>(heaviest, edge.weight);
+    }
+  }
+  if (heaviest * n < std::numeric_limits<std::uint32_t>::max()) {
+    return HeldKarpTable<std::uint32_t>(graph, pool);
+  }
+  return HeldKarpTable<std::uint64_t>(graph, pool);
+}
+
 TsmResult GraphAlgorithms::SolveTravelingSalesmanProblem(const Graph &graph) {
+  return SolveTravelingSalesmanProblem(graph, TsmOptions());
+}
+
+TsmResult
+GraphAlgorithms::SolveTravelingSalesmanProblem(const Graph &graph,
+                                               const TsmOptions &options) {
   if (graph.Size() == 0) {
     throw "";
   }
+  if (options.ants < 1 || options.iterations < 0 || options.rho <= 0.0 ||
+      options.rho > 1.0 || options.time_budget < 0.0 ||
+      options.stagnation_limit < 0 || options.exact_limit < 0 ||
+      options.exact_limit > kMaxExactTsmLimit) {
+    throw "solvetravelingsalesmanproblem: wrong options";
+  }
+  auto started = std::chrono::steady_clock::now();
+  auto elapsed = [started] {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         started)
+        .count();
+  };
   int n = graph.Size();
-  vector<vector<double>> pheromone = InitializePheromone(n);
+  std::uint64_t seed = options.seed;
+  if (seed == 0) {
+    std::random_device rd;
+    seed = (static_cast<std::uint64_t>(rd()) << 32) | rd();
+  }
+  ThreadPool pool(options.threads);
+  if (n <= options.exact_limit) {
+    TsmResult exact = HeldKarp(graph, pool);
+    std::for_each(exact.vertices.begin(), exact.vertices.end(),
+                  [](int &x) { ++x; });
+    if (!exact.vertices.empty() && options.progress) {
+      options.progress(TsmProgress{0, elapsed(), exact});
+    }
+    return exact;
+  }
+  vector<Xoshiro256> random(pool.Size());
+  vector<vector<bool>> visited(pool.Size(), vector<bool>(n));
+
+  Colony colony = InitializeColony(graph, options);
+  UpdateChoiceInfo(colony, graph, pool);
   TsmResult best_result;
   best_result.distance = std::numeric_limits<double>::max();
-  for (int iter = 0; iter < kNumIterations; iter++) {
+  vector<Ant> ants(options.ants);
+  LocalSearch search(graph, colony.candidates, kNumCandidates);
+  int stagnant = 0;
+  for (int iter = 0; iter < options.iterations; iter++) {
+    pool.ParallelFor(options.ants, [&](std::size_t k, int worker) {
+      std::uint64_t stream =
+          seed + static_cast<std::uint64_t>(iter) * options.ants + k;
+      random[worker].Seed(SplitMix64(stream));
+      int start = random[worker].NextInt(n);
+      visited[worker].assign(n, false);
+      ants[k] =
+          BuildTour(start, visited[worker], colony, graph, random[worker]);
+    });
 
-    std::vector<Ant> ants(kNumAnts);
-    std::vector<Ant> succeded_ants;
-
-    std::random_device rd;
-    std::default_random_engine engine(rd());
-    auto gen = std::bind(std::uniform_int_distribution<>(0, n - 2), engine);
-
-    for (int k = 0; k < kNumAnts; k++) {
-      int start = gen();
-
-      std::vector<bool> visited(n, false);
-      ants.at(k) = BuildTour(start, visited, pheromone, graph);
-      int size = ants.at(k).ant_result_.vertices.size();
-      if (size == (n + 1)) {
-        succeded_ants.push_back(ants.at(k));
-        if (ants.at(k).ant_result_.distance <= best_result.distance) {
-          best_result = ants.at(k).ant_result_;
+    if (options.local_search) {
+      Ant *leader = nullptr;
+      for (Ant &ant : ants) {
+        if (static_cast<int>(ant.ant_result_.vertices.size()) == n + 1 &&
+            (!leader ||
+             ant.ant_result_.distance < leader->ant_result_.distance)) {
+          leader = &ant;
         }
       }
+      if (leader) {
+        TsmResult &result = leader->ant_result_;
+        result.distance = search.Improve(result.vertices);
+        leader->quantity_ = kQ / result.distance;
+      }
+    }
+
+    bool improved = false;
+    for (const Ant &ant : ants) {
+      int size = ant.ant_result_.vertices.size();
+      if (size == (n + 1) && ant.ant_result_.distance <= best_result.distance) {
+        improved = improved || ant.ant_result_.distance < best_result.distance;
+        best_result = ant.ant_result_;
+      }
+    }
+    stagnant = improved ? 0 : stagnant + 1;
+    if (improved && options.progress) {
+      TsmProgress progress{iter, elapsed(), best_result};
+      std::for_each(progress.best.vertices.begin(),
+                    progress.best.vertices.end(), [](int &x) { ++x; });
+      if (!options.progress(progress)) {
+        break;
+      }
+    }
+    if ((options.stagnation_limit > 0 &&
+         stagnant >= options.stagnation_limit) ||
+        (options.time_budget > 0.0 && elapsed() >= options.time_budget)) {
+      break;
     }
-    UpdatePheromone(pheromone, succeded_ants, graph);
+    UpdatePheromone(colony, ants);
+    UpdateChoiceInfo(colony, graph, pool);
   }
 
   std::for_each(best_result.vertices.begin(), best_result.vertices.end(),
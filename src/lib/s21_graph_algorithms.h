@@ -1,17 +1,28 @@
 #ifndef NAVIGATOR_SRC_LIB_S21_GRAPH_ALGORITHMS_H_
 #define NAVIGATOR_SRC_LIB_S21_GRAPH_ALGORITHMS_H_
 
+#include <cstdint>
+#include <functional>
 #include <limits>
 #include <string>
 #include <vector>
 
 #include "s21_graph.h"
+#include "s21_indexed_heap.h"
 #include "s21_queue.h"
+#include "s21_random.h"
 #include "s21_stack.h"
 
 namespace s21 {
 
 using std::vector;
+
+class BitMatrix;
+class DistanceMatrix;
+class Landmarks;
+class NextHopMatrix;
+class ThreadPool;
+
 // increase ants, if needed.
 const int kNumAnts = 100;
 // do not increase iterations without requirity.
@@ -21,13 +32,146 @@ const double kBeta = 2.0;
 const double kRHO = 0.5;
 const double kQ = 100.0;
 const double kInitialPheromone = 0.1;
+// nearest neighbors an ant tries before scanning every out-edge.
+const int kNumCandidates = 15;
+// iterations without a shorter tour after which the colony stops.
+const int kStagnationLimit = 200;
+// graphs up to this size get an exact tour from Held-Karp, which takes
+// O(2^V V^2) time and 2^V V table entries.
+const int kExactTsmLimit = 20;
+const int kMaxExactTsmLimit = 25;
 const int kInf = std::numeric_limits<int>::max();
 
+enum class SearchMode {
+  kUnidirectional,
+  // Forward from the source on out-edges and backward from the target on
+  // in-edges; usually settles about half as many vertices.
+  kBidirectional
+};
+
+enum class AllPairsMethod {
+  // Picked from the edge density and the thread count.
+  kAuto,
+  // Blocked Floyd-Warshall, O(V^3) whatever the density.
+  kFloydWarshall,
+  // Johnson's algorithm: one Dijkstra per source, O(V (E + V log V)).
+  kJohnson
+};
+
+// Breadth-first levels from one source. level and parent are indexed by
+// vertex - 1; parent holds the smallest-numbered vertex one level up with
+// an arc to the vertex, 0 for the source and for unreachable vertices.
+struct BfsTree {
+  std::vector<int> level;
+  std::vector<int> parent;
+  // Reached vertices level by level, ascending within a level.
+  std::vector<int> order;
+};
+
 struct TsmResult {
   std::vector<int> vertices;
   double distance;
 };
 
+// Best tour so far (vertices numbered from 1), reported when it improves.
+struct TsmProgress {
+  int iteration;
+  double seconds;
+  TsmResult best;
+};
+
+struct TsmOptions {
+  int ants = kNumAnts;
+  int iterations = kNumIterations;
+  // Weights of pheromone and of 1 / edge weight in the choice rule.
+  double alpha = kAlpha;
+  double beta = kBeta;
+  // Evaporation: trails keep 1 - rho of their pheromone each iteration.
+  double rho = kRHO;
+  // Wall-clock limit in seconds, checked between iterations; 0 = none.
+  double time_budget = 0.0;
+  // Stop after this many iterations without a shorter tour; 0 = never.
+  int stagnation_limit = kStagnationLimit;
+  // Called whenever the best tour improves; returning false stops the
+  // solver, which then returns that tour.
+  std::function<bool(const TsmProgress &)> progress;
+  // Graphs with at most this many vertices are solved exactly instead;
+  // 0 = always run the colony. At most kMaxExactTsmLimit.
+  int exact_limit = kExactTsmLimit;
+  // Polish the best tour of every iteration with 2-opt and Or-opt moves;
+  // the polished tour is deposited in place of the ant's own.
+  bool local_search = true;
+  // Worker threads building ants (0 = one per hardware thread).
+  int threads = 0;
+  // Runs with the same nonzero seed give the same tour whatever the thread
+  // count, unless the time budget cuts them short; 0 takes a seed from
+  // std::random_device.
+  std::uint64_t seed = 0;
+};
+
+// One source / target pair of a batch, vertices numbered from 1.
+struct PathQuery {
+  int source;
+  int target;
+};
+
+// Length and vertices (numbered from 1) of one shortest path; distance is
+// kInf and vertices is empty when there is no path.
+struct ShortestPath {
+  int distance;
+  std::vector<int> vertices;
+};
+
+// Dijkstra tree from one source: the distance and predecessor of every
+// vertex, 4 + 4 bytes each, so paths to any number of targets come from one
+// search. Vertices are numbered from 1.
+class ShortestPathTree {
+public:
+  ShortestPathTree() = default;
+
+  int Source() const { return source_ + 1; }
+  int Size() const { return static_cast<int>(distance_.size()); }
+  // kInf when vertex is unreachable.
+  int Distance(const int vertex) const;
+  // Vertex before this one on its shortest path; 0 for the source and for
+  // unreachable vertices.
+  int Predecessor(const int vertex) const;
+  // Walks the predecessors back from vertex, O(path length).
+  ShortestPath Path(const int vertex) const;
+
+private:
+  friend class GraphAlgorithms;
+
+  int source_ = 0;
+  vector<int> distance_;
+  // Numbered from 0, -1 for none.
+  vector<std::int32_t> predecessor_;
+};
+
+enum class SpanningTreeMethod {
+  // Grows each tree from its lowest vertex with an indexed heap.
+  kPrim,
+  // Adds edges by increasing weight, joining trees in a disjoint set.
+  kKruskal,
+  // Parallel rounds: every component takes its cheapest outgoing edge,
+  // components are merged and the edge list is contracted.
+  kBoruvka
+};
+
+// One edge of a spanning forest, vertices numbered from 1.
+struct TreeEdge {
+  int from;
+  int to;
+  int weight;
+};
+
+// Minimum spanning forest: one tree per connected component, so it has
+// Size() minus the number of components edges.
+struct SpanningForest {
+  std::vector<TreeEdge> edges;
+  long long weight = 0;
+};
+
 struct Ant {
   TsmResult ant_result_;
   double quantity_ = 0;
@@ -38,33 +182,133 @@ public:
   // Part1
   static vector<int> DepthFirstSearch(const Graph &graph, const int start);
   static vector<int> BreadthFirstSearch(const Graph &graph, const int start);
+  // Direction-optimizing BFS (Beamer et al.) over bitmap frontiers: levels
+  // with a large frontier are expanded bottom-up, each unvisited vertex
+  // scanning its in-edges until it finds a frontier parent. start is taken
+  // as in BreadthFirstSearch; level -1 marks unreachable vertices.
+  static BfsTree GetBreadthFirstTree(const Graph &graph, const int start);
+  // BFS levels from many starts: result[i][v - 1] as in
+  // GetBreadthFirstTree(graph, starts[i]).level. Starts are run 64 at a
+  // time as one multi-source BFS (MS-BFS, Then et al.): each vertex keeps
+  // one bit per source in a machine word, so an adjacency row is read once
+  // per level for the whole batch. Batches run on threads workers (0 = one
+  // per hardware thread).
+  static vector<vector<int>> GetBreadthFirstLevels(const Graph &graph,
+                                                   const vector<int> &starts,
+                                                   const int threads = 0);
 
   // Part2
+  // Dijkstra over an indexed 4-ary heap; vertices are numbered from 1 and
+  // kInf is returned when vertex2 is unreachable.
   static int GetShortestPathBetweenVertices(const Graph &graph,
                                             const int vertex1,
                                             const int vertex2);
+  static int GetShortestPathBetweenVertices(const Graph &graph,
+                                            const int vertex1,
+                                            const int vertex2,
+                                            const SearchMode mode);
+  // A* guided by ALT lower bounds from precomputed landmark tables.
+  static int GetShortestPathBetweenVertices(const Graph &graph,
+                                            const Landmarks &landmarks,
+                                            const int vertex1,
+                                            const int vertex2);
+  // One Dijkstra from source to every vertex.
+  static ShortestPathTree GetShortestPathTree(const Graph &graph,
+                                              const int source);
+  // Distances for a batch of queries, kInf where there is no path, in the
+  // order of the queries. Queries are grouped by source so one Dijkstra
+  // answers all targets of a source; it stops once they are all settled.
+  // Groups run on threads workers (0 = one per hardware thread), each
+  // reusing one workspace whose reset does not depend on V.
+  static vector<int> GetShortestPathsBetweenPairs(
+      const Graph &graph, const vector<PathQuery> &queries,
+      const int threads = 0);
   static vector<vector<int>>
   GetShortestPathsBetweenAllVertices(const Graph &graph);
+  // Parallel version over threads workers (0 = one per hardware thread).
+  // The diagonal is the shortest cycle through each vertex either way.
+  static vector<vector<int>>
+  GetShortestPathsBetweenAllVertices(const Graph &graph, const int threads,
+                                     const AllPairsMethod method =
+                                         AllPairsMethod::kAuto);
+  // The same, also filling next_hops with the first vertex of a shortest
+  // path for every pair, so routes unpack without another search.
+  static vector<vector<int>>
+  GetShortestPathsBetweenAllVertices(const Graph &graph, const int threads,
+                                     const AllPairsMethod method,
+                                     NextHopMatrix &next_hops);
+  static AllPairsMethod ChooseAllPairsMethod(const Graph &graph,
+                                             const int threads);
+  // Can i reach j, for all pairs: bit (i, j) of the result (vertices from
+  // 0) is set when a non-empty path leads from i to j. Weights are
+  // ignored; takes V^2 / 8 bytes and V^3 / 64 word operations.
+  static BitMatrix GetTransitiveClosure(const Graph &graph,
+                                        const int threads = 0);
 
   // // Part3
   static vector<vector<int>> GetLeastSpanningTree(const Graph &graph);
+  // Arcs are taken as undirected edges, the lighter one when both
+  // directions exist. O(E log V) with an edge list instead of a V x V
+  // matrix as the result.
+  // threads (0 = one per hardware thread) is used by kBoruvka only.
+  static SpanningForest GetMinimumSpanningForest(
+      const Graph &graph,
+      const SpanningTreeMethod method = SpanningTreeMethod::kKruskal,
+      const int threads = 0);
 
   // Part4
+  // Ant System: every iteration builds options.ants tours concurrently, each
+  // ant drawing from its own xoshiro stream derived from the seed. Graphs
+  // of up to options.exact_limit vertices are solved exactly by Held-Karp.
   static TsmResult SolveTravelingSalesmanProblem(const Graph &graph);
+  static TsmResult SolveTravelingSalesmanProblem(const Graph &graph,
+                                                 const TsmOptions &options);
+  // 2-opt / Or-opt descent from a closed tour (vertices numbered from 1,
+  // first == last); the result starts at the same vertex and is never
+  // longer.
+  static TsmResult ImproveTour(const Graph &graph, const TsmResult &tour);
 
 private:
-  static double Random();
-  static double Eta(int i, int j, const Graph &graph);
-  static vector<vector<double>> InitializePheromone(int n);
-  static void UpdatePheromone(vector<vector<double>> &pheromone,
-                              const vector<Ant> &ants, const Graph &graph);
+  static void BreadthFirstBatch(const Graph &graph, const int *starts,
+                                const int count, vector<int> *levels);
+  static int BidirectionalDijkstra(const Graph &graph, const int source,
+                                   const int target);
+  static DistanceMatrix AllPairs(const Graph &graph, ThreadPool &pool,
+                                 const AllPairsMethod method);
+  static void Johnson(const Graph &graph, ThreadPool &pool,
+                      DistanceMatrix &distances);
+  static SpanningForest PrimForest(const Graph &graph);
+  static SpanningForest KruskalForest(const Graph &graph);
+  static SpanningForest BoruvkaForest(const Graph &graph, ThreadPool &pool);
+  // Exact tour from vertex 0 (vertices numbered from 0); the vertices are
+  // empty when there is no Hamiltonian cycle.
+  static TsmResult HeldKarp(const Graph &graph, ThreadPool &pool);
+  // Tables shared by every ant of an iteration, all flat size x size.
+  struct Colony {
+    int size = 0;
+    double alpha = kAlpha;
+    double beta = kBeta;
+    double rho = kRHO;
+    vector<double> pheromone;
+    // pheromone^alpha * eta^beta on arcs and 0 elsewhere, refreshed after
+    // each pheromone update so tour steps need no pow().
+    vector<double> choice;
+    // kNumCandidates lightest out-neighbors per vertex, -1 padded.
+    vector<int> candidates;
+  };
+
+  static double Eta(const int weight);
+  static Colony InitializeColony(const Graph &graph, const TsmOptions &options);
+  // Evaporates every trail, then adds each complete ant's Q / L.
+  static void UpdatePheromone(Colony &colony, const vector<Ant> &ants);
+  static void UpdateChoiceInfo(Colony &colony, const Graph &graph,
+                               ThreadPool &pool);
 
   static int SelectNext(const int current, const vector<bool> &visited,
-                        const vector<vector<double>> &pheromone,
-                        const Graph &graph);
-  static Ant BuildTour(int start, vector<bool> &visited,
-                       const vector<vector<double>> &pheromone,
-                       const Graph &graph);
+                        const Colony &colony, const Graph &graph,
+                        Xoshiro256 &random);
+  static Ant BuildTour(int start, vector<bool> &visited, const Colony &colony,
+                       const Graph &graph, Xoshiro256 &random);
 };
 
 } // namespace s21
@@ -0,0 +1,132 @@
+#ifndef NAVIGATOR_SRC_LIB_S21_INDEXED_HEAP_H_
+#define NAVIGATOR_SRC_LIB_S21_INDEXED_HEAP_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+
+// Min-heap of integer items in [0, capacity) with an Arity-ary layout and a
+// position index, so decrease-key is O(log n) without duplicate entries.
+template <class Key, int Arity = 4> class IndexedHeap {
+public:
+  using key_type = Key;
+  using size_type = std::size_t;
+
+  IndexedHeap() = default;
+  explicit IndexedHeap(const int capacity) : position_(capacity, kAbsent) {}
+
+  bool empty() const { return heap_.empty(); }
+  size_type size() const { return heap_.size(); }
+  int capacity() const { return static_cast<int>(position_.size()); }
+  bool contains(const int item) const { return position_[item] != kAbsent; }
+
+  int top() const { return heap_.front().item; }
+  const Key &top_key() const { return heap_.front().key; }
+  const Key &key(const int item) const { return heap_[position_[item]].key; }
+
+  void push(const int item, const Key &key) {
+    heap_.push_back(Node{key, item});
+    SiftUp(heap_.size() - 1);
+  }
+
+  void decrease(const int item, const Key &key) {
+    std::size_t slot = position_[item];
+    heap_[slot].key = key;
+    SiftUp(slot);
+  }
+
+  // Inserts the item or lowers its key; returns false if the stored key is
+  // already not greater.
+  bool push_or_decrease(const int item, const Key &key) {
+    if (!contains(item)) {
+      push(item, key);
+      return true;
+    }
+    if (key < heap_[position_[item]].key) {
+      decrease(item, key);
+      return true;
+    }
+    return false;
+  }
+
+  void pop() {
+    position_[heap_.front().item] = kAbsent;
+    Node last = heap_.back();
+    heap_.pop_back();
+    if (!heap_.empty()) {
+      heap_.front() = last;
+      SiftDown(0);
+    }
+  }
+
+  // O(size): only the items still in the heap are reset.
+  void clear() {
+    for (const Node &node : heap_) {
+      position_[node.item] = kAbsent;
+    }
+    heap_.clear();
+  }
+
+  void resize(const int capacity) {
+    clear();
+    position_.assign(capacity, kAbsent);
+  }
+
+private:
+  struct Node {
+    Key key;
+    int item;
+  };
+  static constexpr std::size_t kAbsent = static_cast<std::size_t>(-1);
+
+  void SiftUp(std::size_t slot) {
+    Node node = heap_[slot];
+    while (slot > 0) {
+      std::size_t parent = (slot - 1) / Arity;
+      if (!(node.key < heap_[parent].key)) {
+        break;
+      }
+      Place(slot, heap_[parent]);
+      slot = parent;
+    }
+    Place(slot, node);
+  }
+
+  void SiftDown(std::size_t slot) {
+    Node node = heap_[slot];
+    std::size_t size = heap_.size();
+    while (true) {
+      std::size_t first = slot * Arity + 1;
+      if (first >= size) {
+        break;
+      }
+      std::size_t last = first + Arity < size ? first + Arity : size;
+      std::size_t best = first;
+      for (std::size_t child = first + 1; child < last; ++child) {
+        if (heap_[child].key < heap_[best].key) {
+          best = child;
+        }
+      }
+      if (!(heap_[best].key < node.key)) {
+        break;
+      }
+      Place(slot, heap_[best]);
+      slot = best;
+    }
+    Place(slot, node);
+  }
+
+  void Place(const std::size_t slot, const Node &node) {
+    heap_[slot] = node;
+    position_[node.item] = slot;
+  }
+
+  std::vector<Node> heap_;
+  std::vector<std::size_t> position_;
+};
+
+} // namespace s21
+
+#endif // NAVIGATOR_SRC_LIB_S21_INDEXED_HEAP_H_
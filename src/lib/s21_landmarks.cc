@@ -0,0 +1,131 @@
+#include "s21_landmarks.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "s21_graph_algorithms.h"
+#include "s21_indexed_heap.h"
+#include "s21_snapshot.h"
+
+namespace s21 {
+
+namespace {
+
+enum LandmarkSection : std::uint32_t {
+  kVertices = 1,
+  kFromLandmark,
+  kToLandmark
+};
+
+// One-to-all Dijkstra on out-edges, or on in-edges for distances to source.
+vector<int> DistancesFrom(const Graph &graph, const int source,
+                          const bool backward) {
+  vector<int> distance(graph.Size(), kInf);
+  IndexedHeap<int> heap(graph.Size());
+  distance[source] = 0;
+  heap.push(source, 0);
+  while (!heap.empty()) {
+    int vertex = heap.top();
+    heap.pop();
+    auto edges = backward ? graph.InEdges(vertex) : graph.OutEdges(vertex);
+    for (Edge edge : edges) {
+      int new_distance = distance[vertex] + edge.weight;
+      if (new_distance < distance[edge.to]) {
+        distance[edge.to] = new_distance;
+        heap.push_or_decrease(edge.to, new_distance);
+      }
+    }
+  }
+  return distance;
+}
+
+} // namespace
+
+Landmarks Landmarks::Build(const Graph &graph, const int count) {
+  if (graph.Size() == 0 || count < 1) {
+    throw "landmarks: wrong arguments";
+  }
+  Landmarks result;
+  result.size_ = graph.Size();
+  result.count_ = std::min(count, graph.Size());
+  result.edge_count_ = graph.EdgeCount();
+  std::size_t cells = static_cast<std::size_t>(result.size_) * result.count_;
+  vector<int> from_landmark(cells);
+  vector<int> to_landmark(cells);
+
+  // Distance from the nearest chosen landmark; unreached vertices count as
+  // farthest so every component gets a landmark before any gets two.
+  vector<int> nearest = DistancesFrom(graph, 0, false);
+  for (int l = 0; l < result.count_; ++l) {
+    int landmark = static_cast<int>(
+        std::max_element(nearest.begin(), nearest.end()) - nearest.begin());
+    result.vertices_.push_back(landmark);
+    vector<int> from = DistancesFrom(graph, landmark, false);
+    vector<int> to = DistancesFrom(graph, landmark, true);
+    for (int v = 0; v < result.size_; ++v) {
+      from_landmark[static_cast<std::size_t>(v) * result.count_ + l] = from[v];
+      to_landmark[static_cast<std::size_t>(v) * result.count_ + l] = to[v];
+      nearest[v] = l == 0 ? from[v] : std::min(nearest[v], from[v]);
+    }
+    nearest[landmark] = 0;
+  }
+  result.from_landmark_ = std::move(from_landmark);
+  result.to_landmark_ = std::move(to_landmark);
+  return result;
+}
+
+int Landmarks::LowerBound(const int from, const int to) const {
+  std::size_t row_v = static_cast<std::size_t>(from) * count_;
+  std::size_t row_t = static_cast<std::size_t>(to) * count_;
+  const int *from_v = from_landmark_.data() + row_v;
+  const int *from_t = from_landmark_.data() + row_t;
+  const int *to_v = to_landmark_.data() + row_v;
+  const int *to_t = to_landmark_.data() + row_t;
+  int bound = 0;
+  for (int l = 0; l < count_; ++l) {
+    // d(l, t) <= d(l, v) + d(v, t) and d(v, l) <= d(v, t) + d(t, l).
+    if (from_v[l] != kInf && from_t[l] != kInf) {
+      bound = std::max(bound, from_t[l] - from_v[l]);
+    }
+    if (to_v[l] != kInf && to_t[l] != kInf) {
+      bound = std::max(bound, to_v[l] - to_t[l]);
+    }
+  }
+  return bound;
+}
+
+void Landmarks::Save(std::string filename) const {
+  SnapshotWriter writer(kLandmarksSnapshotKind, kLandmarksSnapshotVersion);
+  writer.SetValue(0, static_cast<std::uint64_t>(size_));
+  writer.SetValue(1, edge_count_);
+  writer.SetValue(2, static_cast<std::uint64_t>(count_));
+  writer.AddSection(kVertices, vertices_.data(), vertices_.size());
+  writer.AddSection(kFromLandmark, from_landmark_.data(), from_landmark_.size());
+  writer.AddSection(kToLandmark, to_landmark_.data(), to_landmark_.size());
+  writer.Write(filename);
+}
+
+void Landmarks::Load(std::string filename, const Graph &graph) {
+  SnapshotReader reader(filename, kLandmarksSnapshotKind,
+                        kLandmarksSnapshotVersion, true);
+  std::uint64_t size = reader.Value(0);
+  std::uint64_t count = reader.Value(2);
+  if (size != static_cast<std::uint64_t>(graph.Size()) ||
+      reader.Value(1) != graph.EdgeCount() || count == 0 || count > size) {
+    throw "landmarks: tables do not match the graph";
+  }
+  auto vertices = reader.Section<int>(kVertices, count);
+  std::size_t cells = size * count;
+  auto from_landmark = reader.Section<int>(kFromLandmark, cells);
+  auto to_landmark = reader.Section<int>(kToLandmark, cells);
+
+  from_landmark_ = std::move(from_landmark);
+  to_landmark_ = std::move(to_landmark);
+  vertices_.assign(vertices.begin(), vertices.end());
+  size_ = static_cast<int>(size);
+  count_ = static_cast<int>(count);
+  edge_count_ = graph.EdgeCount();
+}
+
+} // namespace s21
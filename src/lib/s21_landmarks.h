@@ -0,0 +1,50 @@
+#ifndef NAVIGATOR_SRC_LIB_S21_LANDMARKS_H_
+#define NAVIGATOR_SRC_LIB_S21_LANDMARKS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "s21_graph.h"
+#include "s21_shared_array.h"
+
+namespace s21 {
+
+// Snapshot kind "LMRK" and the layout version written by Landmarks::Save.
+const std::uint32_t kLandmarksSnapshotKind = 0x4B524D4C;
+const std::uint32_t kLandmarksSnapshotVersion = 1;
+
+// Distance tables for ALT (A*, landmarks, triangle inequality) queries. For
+// every vertex v and landmark l the tables hold d(l, v) and d(v, l); both
+// are stored vertex-major so a lower bound reads two short contiguous rows.
+class Landmarks {
+public:
+  Landmarks() = default;
+
+  // Picks count landmarks by farthest-point selection: each new landmark is
+  // the vertex farthest from those already chosen.
+  static Landmarks Build(const Graph &graph, const int count);
+
+  int Count() const { return count_; }
+  int Size() const { return size_; }
+  const vector<int> &Vertices() const { return vertices_; }
+  // Lower bound on d(from, to); 0 when no landmark gives information.
+  int LowerBound(const int from, const int to) const;
+
+  // The file records the graph's vertex and edge counts and Load refuses a
+  // graph that does not match them.
+  void Save(std::string filename) const;
+  void Load(std::string filename, const Graph &graph);
+
+private:
+  int count_ = 0;
+  int size_ = 0;
+  vector<int> vertices_;
+  std::uint64_t edge_count_ = 0;
+  SharedArray<int> from_landmark_;
+  SharedArray<int> to_landmark_;
+};
+
+} // namespace s21
+
+#endif // NAVIGATOR_SRC_LIB_S21_LANDMARKS_H_
@@ -0,0 +1,241 @@
+#include "s21_local_search.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+
+namespace {
+
+// Cost of an arc the graph does not have; large enough that no move
+// creating one pays off, small enough that a tour's worth cannot overflow.
+const long long kMissingArc = 1LL << 40;
+
+// Longest segment Or-opt moves.
+const int kMaxSegment = 3;
+
+} // namespace
+
+vector<int> NearestNeighbors(const Graph &graph, const int count) {
+  int size = graph.Size();
+  vector<int> nearest(static_cast<std::size_t>(size) * count, -1);
+  vector<Edge> row;
+  for (int vertex = 0; vertex < size; ++vertex) {
+    row.clear();
+    for (Edge edge : graph.OutEdges(vertex)) {
+      if (edge.to != vertex) {
+        row.push_back(edge);
+      }
+    }
+    std::size_t kept = std::min(row.size(), static_cast<std::size_t>(count));
+    std::partial_sort(row.begin(), row.begin() + kept, row.end(),
+                      [](const Edge &a, const Edge &b) {
+                        return a.weight < b.weight ||
+                               (a.weight == b.weight && a.to < b.to);
+                      });
+    for (std::size_t i = 0; i < kept; ++i) {
+      nearest[static_cast<std::size_t>(vertex) * count + i] = row[i].to;
+    }
+  }
+  return nearest;
+}
+
+LocalSearch::LocalSearch(const Graph &graph, const int neighbors)
+    : LocalSearch(graph, NearestNeighbors(graph, std::max(neighbors, 1)),
+                  std::max(neighbors, 1)) {}
+
+LocalSearch::LocalSearch(const Graph &graph, vector<int> neighbors,
+                         const int count)
+    : graph_(graph), size_(graph.Size()), neighbor_count_(count),
+      neighbors_(std::move(neighbors)), position_(size_), queued_(size_, 0) {
+  if (count < 1 ||
+      neighbors_.size() != static_cast<std::size_t>(size_) * count) {
+    throw "localsearch: wrong neighbors";
+  }
+  active_.reserve(size_);
+  for (int vertex = 0; vertex < size_ && symmetric_; ++vertex) {
+    for (Edge edge : graph.OutEdges(vertex)) {
+      if (graph.GetEdgeWeight(edge.to, vertex) != edge.weight) {
+        symmetric_ = false;
+        break;
+      }
+    }
+  }
+}
+
+long long LocalSearch::Cost(const int from, const int to) const {
+  int weight = graph_.GetEdgeWeight(from, to);
+  return weight > 0 ? weight : kMissingArc;
+}
+
+double LocalSearch::Improve(vector<int> &tour) {
+  if (static_cast<int>(tour.size()) != size_ + 1 ||
+      tour.front() != tour.back()) {
+    throw "localsearch: wrong tour";
+  }
+  tour_.assign(tour.begin(), tour.end() - 1);
+  std::fill(position_.begin(), position_.end(), -1);
+  for (int i = 0; i < size_; ++i) {
+    if (tour_[i] < 0 || tour_[i] >= size_ || position_[tour_[i]] != -1) {
+      throw "localsearch: wrong tour";
+    }
+    position_[tour_[i]] = i;
+  }
+  int first = tour_.front();
+  RebuildIndex();
+
+  if (size_ >= 4) {
+    for (int vertex : tour_) {
+      Activate(vertex);
+    }
+    while (!active_.empty()) {
+      int vertex = active_.front();
+      active_.pop();
+      queued_[vertex] = 0;
+      if (TryTwoOpt(vertex) || TryOrOpt(vertex)) {
+        Activate(vertex);
+      }
+    }
+  }
+
+  std::rotate(tour_.begin(), tour_.begin() + position_[first], tour_.end());
+  long long length = 0;
+  for (int i = 0; i < size_; ++i) {
+    tour[i] = tour_[i];
+    length += Cost(tour_[i], tour_[Next(i)]);
+  }
+  tour[size_] = first;
+  return static_cast<double>(length);
+}
+
+void LocalSearch::Activate(const int vertex) {
+  if (!queued_[vertex]) {
+    queued_[vertex] = 1;
+    active_.push(vertex);
+  }
+}
+
+void LocalSearch::RebuildIndex() {
+  for (int i = 0; i < size_; ++i) {
+    position_[tour_[i]] = i;
+  }
+  if (symmetric_) {
+    return;
+  }
+  forward_.assign(size_ + 1, 0);
+  backward_.assign(size_ + 1, 0);
+  for (int i = 0; i < size_; ++i) {
+    forward_[i + 1] = forward_[i] + Cost(tour_[i], tour_[Next(i)]);
+    backward_[i + 1] = backward_[i] + Cost(tour_[Next(i)], tour_[i]);
+  }
+}
+
+// Replacing tour edges (lo, lo + 1) and (hi, hi + 1) by (lo, hi) and
+// (lo + 1, hi + 1) reverses positions lo + 1 .. hi.
+long long LocalSearch::TwoOptDelta(const int lo, const int hi) const {
+  int a = tour_[lo];
+  int b = tour_[lo + 1];
+  int c = tour_[hi];
+  int d = tour_[Next(hi)];
+  long long delta = Cost(a, c) + Cost(b, d) - Cost(a, b) - Cost(c, d);
+  if (!symmetric_) {
+    delta += (backward_[hi] - backward_[lo + 1]) -
+             (forward_[hi] - forward_[lo + 1]);
+  }
+  return delta;
+}
+
+bool LocalSearch::TryTwoOpt(const int vertex) {
+  const int *neighbors =
+      neighbors_.data() + static_cast<std::size_t>(vertex) * neighbor_count_;
+  int index = position_[vertex];
+  // Either the edge leaving vertex or the one entering it is removed, and
+  // vertex gets joined to a near neighbor.
+  for (int side = 0; side < 2; ++side) {
+    int own = side == 0 ? index : Prev(index);
+    long long removed = side == 0 ? Cost(vertex, tour_[Next(index)])
+                                  : Cost(tour_[Prev(index)], vertex);
+    for (int k = 0; k < neighbor_count_ && neighbors[k] != -1; ++k) {
+      int other = position_[neighbors[k]];
+      if (symmetric_ && Cost(vertex, neighbors[k]) >= removed) {
+        break;
+      }
+      int lo = std::min(own, side == 0 ? other : Prev(other));
+      int hi = std::max(own, side == 0 ? other : Prev(other));
+      if (hi - lo < 2 || (lo == 0 && hi == size_ - 1)) {
+        continue;
+      }
+      if (TwoOptDelta(lo, hi) < 0) {
+        Activate(tour_[lo]);
+        Activate(tour_[lo + 1]);
+        Activate(tour_[hi]);
+        Activate(tour_[Next(hi)]);
+        std::reverse(tour_.begin() + lo + 1, tour_.begin() + hi + 1);
+        RebuildIndex();
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool LocalSearch::TryOrOpt(const int vertex) {
+  int start = position_[vertex];
+  for (int length = 1; length <= kMaxSegment && length + 3 <= size_;
+       ++length) {
+    int last = start;
+    for (int i = 1; i < length; ++i) {
+      last = Next(last);
+    }
+    int head = tour_[start];
+    int tail = tour_[last];
+    int before = tour_[Prev(start)];
+    int after = tour_[Next(last)];
+    long long gain =
+        Cost(before, head) + Cost(tail, after) - Cost(before, after);
+    auto inside = [&](const int other) {
+      return (position_[other] - start + size_) % size_ < length;
+    };
+    // The segment keeps its direction and goes between x and y, the arc
+    // y being a near neighbor of the tail (and, on undirected graphs, x
+    // one of the head).
+    for (int side = 0; side < (symmetric_ ? 2 : 1); ++side) {
+      int from = side == 0 ? tail : head;
+      const int *neighbors =
+          neighbors_.data() + static_cast<std::size_t>(from) * neighbor_count_;
+      for (int k = 0; k < neighbor_count_ && neighbors[k] != -1; ++k) {
+        int near = neighbors[k];
+        if (Cost(from, near) >= gain) {
+          break;
+        }
+        int x = side == 0 ? tour_[Prev(position_[near])] : near;
+        int y = side == 0 ? near : tour_[Next(position_[near])];
+        if (inside(x) || inside(y)) {
+          continue;
+        }
+        long long delta =
+            Cost(x, head) + Cost(tail, y) - Cost(x, y) - gain;
+        if (delta >= 0) {
+          continue;
+        }
+        Activate(before);
+        Activate(after);
+        Activate(x);
+        Activate(y);
+        Activate(tail);
+        // Rotate the segment to the front, then slide it behind x.
+        std::rotate(tour_.begin(), tour_.begin() + start, tour_.end());
+        int x_index = static_cast<int>(
+            std::find(tour_.begin(), tour_.end(), x) - tour_.begin());
+        std::rotate(tour_.begin(), tour_.begin() + length,
+                    tour_.begin() + x_index + 1);
+        RebuildIndex();
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+} // namespace s21
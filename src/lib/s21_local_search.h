@@ -0,0 +1,67 @@
+#ifndef NAVIGATOR_SRC_LIB_S21_LOCAL_SEARCH_H_
+#define NAVIGATOR_SRC_LIB_S21_LOCAL_SEARCH_H_
+
+#include <vector>
+
+#include "s21_graph.h"
+#include "s21_graph_algorithms.h"
+
+namespace s21 {
+
+// The count lightest out-neighbors of every vertex other than itself,
+// lighter (then lower numbered) first: row v is [v * count, (v + 1) * count),
+// -1 padded.
+vector<int> NearestNeighbors(const Graph &graph, const int count);
+
+// 2-opt and Or-opt descent for closed tours of one graph. Moves are only
+// tried against each city's nearest neighbors, and a city leaves the work
+// queue (its don't-look bit is set) once no move around it improves the
+// tour; it comes back when a move changes one of its tour edges.
+//
+// Missing arcs cost so much that no move creates one. On directed graphs a
+// 2-opt move also pays for running the reversed segment backwards, which
+// prefix sums of the forward and backward edge costs give in O(1).
+class LocalSearch {
+public:
+  explicit LocalSearch(const Graph &graph,
+                       const int neighbors = kNumCandidates);
+  // Takes lists already built by NearestNeighbors(graph, count).
+  LocalSearch(const Graph &graph, vector<int> neighbors, const int count);
+
+  // tour holds vertices from 0 with front() == back(); it is improved in
+  // place, keeps its first vertex and the new length is returned.
+  double Improve(vector<int> &tour);
+
+private:
+  long long Cost(const int from, const int to) const;
+  int Next(const int index) const {
+    return index + 1 == size_ ? 0 : index + 1;
+  }
+  int Prev(const int index) const {
+    return index == 0 ? size_ - 1 : index - 1;
+  }
+  void Activate(const int vertex);
+  void RebuildIndex();
+  bool TryTwoOpt(const int vertex);
+  bool TryOrOpt(const int vertex);
+  long long TwoOptDelta(const int lo, const int hi) const;
+
+  const Graph &graph_;
+  int size_ = 0;
+  int neighbor_count_ = 0;
+  bool symmetric_ = true;
+  // neighbor_count_ lightest out-neighbors per vertex, -1 padded.
+  vector<int> neighbors_;
+  vector<int> tour_;
+  vector<int> position_;
+  // forward_[k] / backward_[k]: cost of tour edges 0..k-1 walked forwards
+  // / backwards. Only kept for directed graphs.
+  vector<long long> forward_;
+  vector<long long> backward_;
+  Queue<int> active_;
+  vector<char> queued_;
+};
+
+} // namespace s21
+
+#endif // NAVIGATOR_SRC_LIB_S21_LOCAL_SEARCH_H_
@@ -0,0 +1,46 @@
+#include "s21_mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+namespace s21 {
+
+MappedFile::MappedFile(const std::string &filename) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw "mappedfile: wrong file";
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+    close(fd);
+    throw "mappedfile: wrong file";
+  }
+  size_ = static_cast<std::size_t>(info.st_size);
+  if (size_ > 0) {
+    void *address = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+      close(fd);
+      throw "mappedfile: wrong file";
+    }
+    data_ = static_cast<const char *>(address);
+  }
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char *>(data_), size_);
+  }
+}
+
+void MappedFile::AdviseSequential() const {
+  if (data_ != nullptr) {
+    madvise(const_cast<char *>(data_), size_, MADV_SEQUENTIAL);
+  }
+}
+
+} // namespace s21
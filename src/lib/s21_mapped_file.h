@@ -0,0 +1,30 @@
+#ifndef NAVIGATOR_SRC_LIB_S21_MAPPED_FILE_H_
+#define NAVIGATOR_SRC_LIB_S21_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+namespace s21 {
+
+// Read-only memory mapping of a whole file. The mapping lives as long as the
+// object; an empty file maps to a null data pointer of size 0.
+class MappedFile {
+public:
+  explicit MappedFile(const std::string &filename);
+  MappedFile(const MappedFile &other) = delete;
+  MappedFile &operator=(const MappedFile &other) = delete;
+  ~MappedFile();
+
+  const char *Data() const { return data_; }
+  std::size_t Size() const { return size_; }
+  // Hints the kernel that the mapping will be read front to back.
+  void AdviseSequential() const;
+
+private:
+  const char *data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+} // namespace s21
+
+#endif // NAVIGATOR_SRC_LIB_S21_MAPPED_FILE_H_
@@ -0,0 +1,148 @@
+#include "s21_next_hop_matrix.h"
+
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "s21_distance_matrix.h"
+#include "s21_graph_algorithms.h"
+#include "s21_snapshot.h"
+#include "s21_thread_pool.h"
+
+namespace s21 {
+
+namespace {
+
+enum NextHopSection : std::uint32_t { kNarrowHops = 1, kWideHops };
+
+const std::uint16_t kNarrowNone = std::numeric_limits<std::uint16_t>::max();
+const std::uint32_t kWideNone = std::numeric_limits<std::uint32_t>::max();
+
+template <class Index>
+vector<Index> BuildHops(const Graph &graph, const DistanceMatrix &distances,
+                        ThreadPool &pool) {
+  const int n = graph.Size();
+  const Index none = std::numeric_limits<Index>::max();
+  vector<Index> hops(static_cast<std::size_t>(n) * n, none);
+  pool.ParallelFor(
+      n,
+      [&](std::size_t from, int) {
+        const int *target = distances.Row(static_cast<int>(from));
+        Index *row = hops.data() + from * n;
+        // Out-edges come in ascending order, so the first neighbor to match
+        // a column is the smallest one; each pass streams one row of d.
+        for (Edge edge : graph.OutEdges(static_cast<int>(from))) {
+          const int *through = distances.Row(edge.to);
+          for (int to = 0; to < n; ++to) {
+            if (row[to] != none || target[to] == kInf) {
+              continue;
+            }
+            long long rest = to == edge.to ? 0 : through[to];
+            if (rest != kInf && edge.weight + rest == target[to]) {
+              row[to] = static_cast<Index>(edge.to);
+            }
+          }
+        }
+      },
+      16);
+  return hops;
+}
+
+} // namespace
+
+NextHopMatrix NextHopMatrix::Build(const Graph &graph,
+                                   const DistanceMatrix &distances,
+                                   ThreadPool &pool) {
+  if (distances.Size() != graph.Size()) {
+    throw "nexthopmatrix: distances do not match the graph";
+  }
+  NextHopMatrix matrix;
+  matrix.size_ = graph.Size();
+  matrix.edge_count_ = graph.EdgeCount();
+  if (matrix.size_ < kNarrowNone) {
+    matrix.narrow_ = BuildHops<std::uint16_t>(graph, distances, pool);
+  } else {
+    matrix.wide_ = BuildHops<std::uint32_t>(graph, distances, pool);
+  }
+  return matrix;
+}
+
+int NextHopMatrix::Hop(const int from, const int to) const {
+  std::size_t cell = static_cast<std::size_t>(from) * size_ + to;
+  if (!narrow_.empty()) {
+    return narrow_[cell] == kNarrowNone ? -1 : narrow_[cell];
+  }
+  return wide_[cell] == kWideNone ? -1 : static_cast<int>(wide_[cell]);
+}
+
+int NextHopMatrix::Next(const int from, const int to) const {
+  if (from < 1 || from > size_ || to < 1 || to > size_) {
+    throw "";
+  }
+  return Hop(from - 1, to - 1) + 1;
+}
+
+vector<int> NextHopMatrix::Path(const int from, const int to) const {
+  if (from < 1 || from > size_ || to < 1 || to > size_) {
+    throw "";
+  }
+  vector<int> path;
+  int current = from - 1;
+  int target = to - 1;
+  if (Hop(current, target) == -1) {
+    return path;
+  }
+  path.push_back(from);
+  do {
+    current = Hop(current, target);
+    // A table built from consistent distances always gets closer; only a
+    // damaged file can loop or break off.
+    if (current < 0 || current >= size_ ||
+        static_cast<int>(path.size()) > size_) {
+      throw "nexthopmatrix: broken table";
+    }
+    path.push_back(current + 1);
+  } while (current != target);
+  return path;
+}
+
+void NextHopMatrix::Save(std::string filename) const {
+  SnapshotWriter writer(kNextHopSnapshotKind, kNextHopSnapshotVersion);
+  writer.SetValue(0, static_cast<std::uint64_t>(size_));
+  writer.SetValue(1, edge_count_);
+  writer.SetValue(2, IsNarrow() ? 16 : 32);
+  if (IsNarrow()) {
+    writer.AddSection(kNarrowHops, narrow_.data(), narrow_.size());
+  } else {
+    writer.AddSection(kWideHops, wide_.data(), wide_.size());
+  }
+  writer.Write(filename);
+}
+
+void NextHopMatrix::Load(std::string filename, const Graph &graph) {
+  SnapshotReader reader(filename, kNextHopSnapshotKind,
+                        kNextHopSnapshotVersion, true);
+  std::uint64_t size = reader.Value(0);
+  std::uint64_t bits = reader.Value(2);
+  if (size != static_cast<std::uint64_t>(graph.Size()) ||
+      reader.Value(1) != graph.EdgeCount() ||
+      bits != (size < kNarrowNone ? 16u : 32u)) {
+    throw "nexthopmatrix: table does not match the graph";
+  }
+  std::size_t cells = size * size;
+  SharedArray<std::uint16_t> narrow;
+  SharedArray<std::uint32_t> wide;
+  if (bits == 16) {
+    narrow = reader.Section<std::uint16_t>(kNarrowHops, cells);
+  } else {
+    wide = reader.Section<std::uint32_t>(kWideHops, cells);
+  }
+
+  narrow_ = std::move(narrow);
+  wide_ = std::move(wide);
+  size_ = static_cast<int>(size);
+  edge_count_ = graph.EdgeCount();
+}
+
+} // namespace s21
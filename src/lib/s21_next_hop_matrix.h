@@ -0,0 +1,62 @@
+#ifndef NAVIGATOR_SRC_LIB_S21_NEXT_HOP_MATRIX_H_
+#define NAVIGATOR_SRC_LIB_S21_NEXT_HOP_MATRIX_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "s21_graph.h"
+#include "s21_shared_array.h"
+
+namespace s21 {
+
+class DistanceMatrix;
+class ThreadPool;
+
+// Snapshot kind "NHOP" and the layout version written by
+// NextHopMatrix::Save.
+const std::uint32_t kNextHopSnapshotKind = 0x504F484E;
+const std::uint32_t kNextHopSnapshotVersion = 1;
+
+// Route table for all pairs: entry (from, to) is the first vertex after
+// from on a shortest path to to. Entries are 16-bit while the vertices fit
+// below 65535 and 32-bit otherwise, the largest value meaning "no path".
+class NextHopMatrix {
+public:
+  NextHopMatrix() = default;
+
+  // From finished all-pairs distances (the diagonal being the shortest
+  // cycle): the hop is the smallest out-neighbor k with w(from, k) +
+  // d(k, to) = d(from, to). O(V E), rows spread over the pool.
+  static NextHopMatrix Build(const Graph &graph,
+                             const DistanceMatrix &distances,
+                             ThreadPool &pool);
+
+  int Size() const { return size_; }
+  // True when entries take 16 bits.
+  bool IsNarrow() const { return !narrow_.empty() || size_ == 0; }
+
+  // Vertices from 1; 0 when there is no path.
+  int Next(const int from, const int to) const;
+  // from, ..., to in O(path length); empty when there is no path. For
+  // from == to this is the shortest cycle through the vertex.
+  vector<int> Path(const int from, const int to) const;
+
+  // The file records the graph's vertex and edge counts and Load refuses a
+  // graph that does not match them. Loading maps the table in place.
+  void Save(std::string filename) const;
+  void Load(std::string filename, const Graph &graph);
+
+private:
+  // Numbered from 0, -1 for no path.
+  int Hop(const int from, const int to) const;
+
+  int size_ = 0;
+  std::uint64_t edge_count_ = 0;
+  SharedArray<std::uint16_t> narrow_;
+  SharedArray<std::uint32_t> wide_;
+};
+
+} // namespace s21
+
+#endif // NAVIGATOR_SRC_LIB_S21_NEXT_HOP_MATRIX_H_
@@ -2,11 +2,12 @@
 #define NAVIGATOR_SRC_LIB_S21_QUEUE_H_
 
 #include <initializer_list>
-#include <list>
 #include <utility>
 
+#include "s21_ring_buffer.h"
+
 namespace s21 {
-template <class T, class Container = std::list<T>> class Queue {
+template <class T, class Container = RingBuffer<T>> class Queue {
 public:
   using value_type = T;
   using reference = T &;
@@ -18,7 +19,7 @@ public:
       : cont_(Container(items)) {}
   Queue(const Queue &src) : cont_(src.cont_) {}
   Queue(Queue &&src) : cont_(std::move(src.cont_)) {}
-  auto operator=(Queue &&src) {
+  Queue &operator=(Queue &&src) {
     cont_ = std::move(src.cont_);
     return *this;
   }
@@ -36,11 +37,18 @@ public:
   size_type size() const { return cont_.size(); }
 
   void push(const_reference value) { cont_.push_back(value); }
+  void push(value_type &&value) { cont_.push_back(std::move(value)); }
   void pop() { cont_.pop_front(); }
   void swap(Queue &other) { cont_.swap(other.cont_); }
+  // Room for count items without allocating again.
+  void reserve(const size_type count) { cont_.reserve(count); }
+  void clear() { cont_.clear(); }
 
+  template <class... Args> void emplace(Args &&...args) {
+    cont_.emplace_back(std::forward<Args>(args)...);
+  }
   template <class... Args> void emplace_back(Args &&...args) {
-    cont_.emplace_back(args...);
+    cont_.emplace_back(std::forward<Args>(args)...);
   }
 
 private:
@@ -0,0 +1,76 @@
+#ifndef NAVIGATOR_SRC_LIB_S21_RANDOM_H_
+#define NAVIGATOR_SRC_LIB_S21_RANDOM_H_
+
+#include <cstdint>
+#include <limits>
+
+namespace s21 {
+
+// SplitMix64 step; spreads consecutive counters into unrelated seeds.
+inline std::uint64_t SplitMix64(std::uint64_t &state) {
+  std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+// xoshiro256** by Blackman and Vigna: small state, a few cycles per number
+// and cheap to reseed, so one generator can serve a stream per task.
+// Satisfies UniformRandomBitGenerator.
+class Xoshiro256 {
+public:
+  using result_type = std::uint64_t;
+
+  explicit Xoshiro256(const std::uint64_t seed = 0) { Seed(seed); }
+
+  void Seed(std::uint64_t seed) {
+    for (std::uint64_t &word : state_) {
+      word = SplitMix64(seed);
+    }
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()() {
+    result_type result = Rotate(state_[1] * 5, 7) * 9;
+    result_type shifted = state_[1] << 17;
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= shifted;
+    state_[3] = Rotate(state_[3], 45);
+    return result;
+  }
+
+  // Uniform in [0, 1) from the top 53 bits.
+  double NextDouble() { return ((*this)() >> 11) * 0x1.0p-53; }
+  // Uniform in [0, bound), bound > 0, by Lemire's multiply-shift with
+  // rejection: the 2^32 mod bound products whose low half falls below that
+  // threshold are drawn again, so every value is equally likely.
+  int NextInt(const int bound) {
+    std::uint64_t range = static_cast<std::uint32_t>(bound);
+    std::uint64_t product = ((*this)() >> 32) * range;
+    if (static_cast<std::uint32_t>(product) < range) {
+      std::uint32_t threshold = static_cast<std::uint32_t>(-range) % range;
+      while (static_cast<std::uint32_t>(product) < threshold) {
+        product = ((*this)() >> 32) * range;
+      }
+    }
+    return static_cast<int>(product >> 32);
+  }
+
+private:
+  static result_type Rotate(const result_type value, const int shift) {
+    return (value << shift) | (value >> (64 - shift));
+  }
+
+  result_type state_[4];
+};
+
+} // namespace s21
+
+#endif // NAVIGATOR_SRC_LIB_S21_RANDOM_H_
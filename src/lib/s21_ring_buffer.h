@@ -0,0 +1,130 @@
+#ifndef NAVIGATOR_SRC_LIB_S21_RING_BUFFER_H_
+#define NAVIGATOR_SRC_LIB_S21_RING_BUFFER_H_
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace s21 {
+
+// Growable FIFO storage in one contiguous block: items live in a power of
+// two sized ring, so push_back and pop_front are an index update and only
+// outgrowing the capacity allocates (the ring doubles).
+template <class T> class RingBuffer {
+public:
+  using value_type = T;
+  using reference = T &;
+  using const_reference = const T &;
+  using size_type = std::size_t;
+
+  RingBuffer() = default;
+  RingBuffer(std::initializer_list<value_type> const &items) {
+    reserve(items.size());
+    for (const_reference item : items) {
+      push_back(item);
+    }
+  }
+  RingBuffer(const RingBuffer &src) {
+    reserve(src.size_);
+    for (size_type i = 0; i < src.size_; ++i) {
+      push_back(src.At(i));
+    }
+  }
+  RingBuffer(RingBuffer &&src) noexcept { swap(src); }
+  RingBuffer &operator=(const RingBuffer &src) {
+    if (this != &src) {
+      RingBuffer copy(src);
+      swap(copy);
+    }
+    return *this;
+  }
+  RingBuffer &operator=(RingBuffer &&src) noexcept {
+    if (this != &src) {
+      RingBuffer moved(std::move(src));
+      swap(moved);
+    }
+    return *this;
+  }
+  ~RingBuffer() {
+    clear();
+    std::allocator<T>().deallocate(data_, capacity_);
+  }
+
+  reference front() { return data_[head_]; }
+  const_reference front() const { return data_[head_]; }
+  reference back() { return At(size_ - 1); }
+  const_reference back() const { return At(size_ - 1); }
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
+  size_type capacity() const { return capacity_; }
+
+  void push_back(const_reference value) { emplace_back(value); }
+  void push_back(value_type &&value) { emplace_back(std::move(value)); }
+  template <class... Args> reference emplace_back(Args &&...args) {
+    if (size_ == capacity_) {
+      reserve(size_ + 1);
+    }
+    T *slot = &data_[(head_ + size_) & (capacity_ - 1)];
+    ::new (static_cast<void *>(slot)) T(std::forward<Args>(args)...);
+    ++size_;
+    return *slot;
+  }
+  void pop_front() {
+    data_[head_].~T();
+    head_ = (head_ + 1) & (capacity_ - 1);
+    --size_;
+  }
+  void clear() {
+    while (size_ != 0) {
+      pop_front();
+    }
+    head_ = 0;
+  }
+
+  // Makes room for count items; the capacity is rounded up to a power of
+  // two and never shrinks.
+  void reserve(const size_type count) {
+    if (count <= capacity_) {
+      return;
+    }
+    size_type capacity = capacity_ == 0 ? 8 : capacity_;
+    while (capacity < count) {
+      capacity *= 2;
+    }
+    T *data = std::allocator<T>().allocate(capacity);
+    for (size_type i = 0; i < size_; ++i) {
+      ::new (static_cast<void *>(&data[i])) T(std::move_if_noexcept(At(i)));
+      At(i).~T();
+    }
+    std::allocator<T>().deallocate(data_, capacity_);
+    data_ = data;
+    capacity_ = capacity;
+    head_ = 0;
+  }
+
+  void swap(RingBuffer &other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(head_, other.head_);
+    std::swap(size_, other.size_);
+  }
+
+private:
+  reference At(const size_type index) {
+    return data_[(head_ + index) & (capacity_ - 1)];
+  }
+  const_reference At(const size_type index) const {
+    return data_[(head_ + index) & (capacity_ - 1)];
+  }
+
+  T *data_ = nullptr;
+  size_type capacity_ = 0;
+  size_type head_ = 0;
+  size_type size_ = 0;
+};
+
+} // namespace s21
+
+#endif // NAVIGATOR_SRC_LIB_S21_RING_BUFFER_H_
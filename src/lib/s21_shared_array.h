@@ -0,0 +1,84 @@
+#ifndef NAVIGATOR_SRC_LIB_S21_SHARED_ARRAY_H_
+#define NAVIGATOR_SRC_LIB_S21_SHARED_ARRAY_H_
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "s21_mapped_file.h"
+
+namespace s21 {
+
+// Read-only contiguous array that either owns its elements or views a slice
+// of a memory-mapped file kept alive by a shared pointer. Copies of a mapped
+// array share the mapping instead of duplicating the data.
+template <class T> class SharedArray {
+public:
+  using value_type = T;
+  using const_iterator = const T *;
+  using size_type = std::size_t;
+
+  SharedArray() = default;
+  SharedArray(std::vector<T> &&owned)
+      : owned_(std::move(owned)), data_(owned_.data()), size_(owned_.size()) {}
+  SharedArray(std::shared_ptr<const MappedFile> mapping, const T *data,
+              const size_type size)
+      : mapping_(std::move(mapping)), data_(data), size_(size) {}
+
+  SharedArray(const SharedArray &src)
+      : owned_(src.owned_), mapping_(src.mapping_), size_(src.size_) {
+    data_ = mapping_ ? src.data_ : owned_.data();
+  }
+  SharedArray(SharedArray &&src) noexcept
+      : owned_(std::move(src.owned_)), mapping_(std::move(src.mapping_)),
+        size_(src.size_) {
+    data_ = mapping_ ? src.data_ : owned_.data();
+    src.data_ = nullptr;
+    src.size_ = 0;
+  }
+  SharedArray &operator=(const SharedArray &src) {
+    if (this != &src) {
+      SharedArray copy(src);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+  SharedArray &operator=(SharedArray &&src) noexcept {
+    if (this != &src) {
+      owned_ = std::move(src.owned_);
+      mapping_ = std::move(src.mapping_);
+      size_ = src.size_;
+      data_ = mapping_ ? src.data_ : owned_.data();
+      src.data_ = nullptr;
+      src.size_ = 0;
+    }
+    return *this;
+  }
+  ~SharedArray() = default;
+
+  const T *data() const { return data_; }
+  size_type size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const_iterator begin() const { return data_; }
+  const_iterator end() const { return data_ + size_; }
+  const T &operator[](const size_type index) const { return data_[index]; }
+  const T &at(const size_type index) const {
+    if (index >= size_) {
+      throw "sharedarray: index out of range";
+    }
+    return data_[index];
+  }
+  // True when the elements live in a file mapping rather than on the heap.
+  bool IsMapped() const { return static_cast<bool>(mapping_); }
+
+private:
+  std::vector<T> owned_;
+  std::shared_ptr<const MappedFile> mapping_;
+  const T *data_ = nullptr;
+  size_type size_ = 0;
+};
+
+} // namespace s21
+
+#endif // NAVIGATOR_SRC_LIB_S21_SHARED_ARRAY_H_
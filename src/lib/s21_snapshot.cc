@@ -0,0 +1,216 @@
+#include "s21_snapshot.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace s21 {
+
+namespace {
+
+const char kMagic[8] = {'S', '2', '1', 'S', 'N', 'A', 'P', '\0'};
+
+struct SectionEntry {
+  std::uint32_t tag;
+  std::uint32_t reserved;
+  std::uint64_t offset;
+  std::uint64_t bytes;
+};
+
+struct Header {
+  char magic[8];
+  std::uint32_t kind;
+  std::uint32_t version;
+  std::uint32_t section_count;
+  std::uint32_t reserved;
+  std::uint64_t values[kSnapshotValues];
+  SectionEntry sections[kSnapshotMaxSections];
+  std::uint64_t payload_checksum;
+  std::uint64_t header_checksum;
+};
+
+static_assert(sizeof(Header) <= kSnapshotPageSize,
+              "snapshot header must fit in one page");
+
+const std::uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+const std::uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+
+std::uint64_t Rotate(const std::uint64_t value, const int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+std::uint64_t Mix(std::uint64_t lane, const std::uint64_t word) {
+  return Rotate(lane ^ (word * kPrime2), 31) * kPrime1;
+}
+
+std::size_t AlignToPage(const std::size_t bytes) {
+  return (bytes + kSnapshotPageSize - 1) / kSnapshotPageSize *
+         kSnapshotPageSize;
+}
+
+std::uint64_t HeaderChecksum(const Header &header) {
+  return Checksum(&header, offsetof(Header, header_checksum));
+}
+
+} // namespace
+
+bool IsSnapshot(const char *data, std::size_t bytes) {
+  return bytes >= sizeof(kMagic) &&
+         std::memcmp(data, kMagic, sizeof(kMagic)) == 0;
+}
+
+std::uint64_t Checksum(const void *data, std::size_t bytes,
+                       std::uint64_t seed) {
+  const unsigned char *pos = static_cast<const unsigned char *>(data);
+  // Four independent lanes keep the multipliers busy; 32 bytes per step.
+  std::uint64_t lanes[4] = {seed + kPrime1, seed ^ kPrime2, seed,
+                            seed - kPrime1};
+  std::size_t blocks = bytes / 32;
+  for (std::size_t b = 0; b < blocks; ++b, pos += 32) {
+    for (int lane = 0; lane < 4; ++lane) {
+      std::uint64_t word;
+      std::memcpy(&word, pos + lane * 8, sizeof(word));
+      lanes[lane] = Mix(lanes[lane], word);
+    }
+  }
+  std::uint64_t hash = Rotate(lanes[0], 1) + Rotate(lanes[1], 7) +
+                       Rotate(lanes[2], 12) + Rotate(lanes[3], 18) +
+                       static_cast<std::uint64_t>(bytes);
+  for (std::size_t rest = bytes % 32; rest > 0; --rest, ++pos) {
+    hash = Mix(hash, *pos);
+  }
+  hash ^= hash >> 33;
+  hash *= kPrime2;
+  hash ^= hash >> 29;
+  return hash;
+}
+
+SnapshotWriter::SnapshotWriter(std::uint32_t kind, std::uint32_t version)
+    : kind_(kind), version_(version) {}
+
+void SnapshotWriter::SetValue(const int index, const std::uint64_t value) {
+  if (index < 0 || index >= kSnapshotValues) {
+    throw "snapshot: wrong value index";
+  }
+  values_[index] = value;
+}
+
+void SnapshotWriter::AddRawSection(const std::uint32_t tag, const void *data,
+                                   const std::size_t bytes) {
+  if (static_cast<int>(sections_.size()) == kSnapshotMaxSections) {
+    throw "snapshot: too many sections";
+  }
+  sections_.push_back(Pending{tag, data, bytes});
+}
+
+void SnapshotWriter::Write(const std::string &filename) const {
+  Header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.kind = kind_;
+  header.version = version_;
+  header.section_count = static_cast<std::uint32_t>(sections_.size());
+  std::memcpy(header.values, values_, sizeof(values_));
+
+  std::uint64_t offset = kSnapshotPageSize;
+  std::uint64_t payload = 0;
+  for (std::size_t i = 0; i < sections_.size(); ++i) {
+    header.sections[i] =
+        SectionEntry{sections_[i].tag, 0, offset, sections_[i].bytes};
+    offset += AlignToPage(sections_[i].bytes);
+    payload = Checksum(sections_[i].data, sections_[i].bytes, payload);
+  }
+  header.payload_checksum = payload;
+  header.header_checksum = HeaderChecksum(header);
+
+  // Written next to the target and renamed, so readers never map a
+  // half-written snapshot.
+  std::string temporary = filename + ".tmp";
+  std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    throw "snapshot: wrong file";
+  }
+  const std::vector<char> padding(kSnapshotPageSize, 0);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(padding.data(), kSnapshotPageSize - sizeof(header));
+  for (const Pending &section : sections_) {
+    file.write(static_cast<const char *>(section.data), section.bytes);
+    file.write(padding.data(),
+               AlignToPage(section.bytes) - section.bytes);
+  }
+  file.close();
+  if (!file || std::rename(temporary.c_str(), filename.c_str()) != 0) {
+    std::remove(temporary.c_str());
+    throw "snapshot: wrong file";
+  }
+}
+
+SnapshotReader::SnapshotReader(const std::string &filename,
+                               std::uint32_t kind, std::uint32_t version,
+                               bool verify_payload)
+    : file_(std::make_shared<const MappedFile>(filename)) {
+  Header header;
+  if (file_->Size() < kSnapshotPageSize) {
+    throw "snapshot: wrong file";
+  }
+  std::memcpy(&header, file_->Data(), sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.header_checksum != HeaderChecksum(header)) {
+    throw "snapshot: wrong file";
+  }
+  if (header.kind != kind || header.version != version ||
+      header.section_count > static_cast<std::uint32_t>(kSnapshotMaxSections)) {
+    throw "snapshot: unsupported file";
+  }
+  std::uint64_t payload = 0;
+  for (std::uint32_t i = 0; i < header.section_count; ++i) {
+    const SectionEntry &entry = header.sections[i];
+    if (entry.offset % kSnapshotPageSize != 0 || entry.offset > file_->Size() ||
+        entry.bytes > file_->Size() - entry.offset) {
+      throw "snapshot: wrong file";
+    }
+    if (verify_payload) {
+      payload = Checksum(file_->Data() + entry.offset, entry.bytes, payload);
+    }
+  }
+  if (verify_payload && payload != header.payload_checksum) {
+    throw "snapshot: checksum mismatch";
+  }
+}
+
+std::uint64_t SnapshotReader::Value(const int index) const {
+  if (index < 0 || index >= kSnapshotValues) {
+    throw "snapshot: wrong value index";
+  }
+  std::uint64_t value;
+  std::memcpy(&value,
+              file_->Data() + offsetof(Header, values) +
+                  index * sizeof(std::uint64_t),
+              sizeof(value));
+  return value;
+}
+
+bool SnapshotReader::HasSection(const std::uint32_t tag) const {
+  const char *data = nullptr;
+  std::size_t bytes = 0;
+  return FindSection(tag, data, bytes);
+}
+
+bool SnapshotReader::FindSection(const std::uint32_t tag, const char *&data,
+                                 std::size_t &bytes) const {
+  Header header;
+  std::memcpy(&header, file_->Data(), sizeof(header));
+  for (std::uint32_t i = 0; i < header.section_count; ++i) {
+    if (header.sections[i].tag == tag) {
+      data = file_->Data() + header.sections[i].offset;
+      bytes = header.sections[i].bytes;
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace s21
@@ -0,0 +1,94 @@
+#ifndef NAVIGATOR_SRC_LIB_S21_SNAPSHOT_H_
+#define NAVIGATOR_SRC_LIB_S21_SNAPSHOT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "s21_mapped_file.h"
+#include "s21_shared_array.h"
+
+namespace s21 {
+
+// Binary snapshot container shared by every on-disk structure. A file is a
+// header page followed by tagged sections, each starting on a page boundary
+// so a mapped section can be used in place as a typed array.
+//
+// Header layout (little-endian, native widths):
+//   magic "S21SNAP", kind, version, section count, eight user values,
+//   section table {tag, offset, bytes}, payload checksum, header checksum.
+const std::size_t kSnapshotPageSize = 4096;
+const int kSnapshotMaxSections = 16;
+const int kSnapshotValues = 8;
+
+// True when the bytes start with the snapshot magic.
+bool IsSnapshot(const char *data, std::size_t bytes);
+
+std::uint64_t Checksum(const void *data, std::size_t bytes,
+                       std::uint64_t seed = 0);
+
+class SnapshotWriter {
+public:
+  SnapshotWriter(std::uint32_t kind, std::uint32_t version);
+
+  void SetValue(const int index, const std::uint64_t value);
+  // The data must stay valid until Write returns.
+  template <class T>
+  void AddSection(const std::uint32_t tag, const T *data,
+                  const std::size_t count) {
+    AddRawSection(tag, data, count * sizeof(T));
+  }
+  void Write(const std::string &filename) const;
+
+private:
+  struct Pending {
+    std::uint32_t tag;
+    const void *data;
+    std::size_t bytes;
+  };
+  void AddRawSection(const std::uint32_t tag, const void *data,
+                     const std::size_t bytes);
+
+  std::uint32_t kind_;
+  std::uint32_t version_;
+  std::uint64_t values_[kSnapshotValues] = {};
+  std::vector<Pending> sections_;
+};
+
+class SnapshotReader {
+public:
+  // Maps the file and validates magic, kind, version and the header
+  // checksum. The payload checksum costs a full read of the file and is
+  // only checked when verify_payload is set.
+  SnapshotReader(const std::string &filename, std::uint32_t kind,
+                 std::uint32_t version, bool verify_payload);
+
+  std::uint64_t Value(const int index) const;
+  bool HasSection(const std::uint32_t tag) const;
+  // Zero-copy view of a section; the array keeps the mapping alive.
+  template <class T>
+  SharedArray<T> Section(const std::uint32_t tag,
+                         const std::size_t expected_count) const {
+    const char *data = nullptr;
+    std::size_t bytes = 0;
+    if (!FindSection(tag, data, bytes) || expected_count > bytes / sizeof(T) ||
+        bytes != expected_count * sizeof(T)) {
+      throw "snapshot: wrong section size";
+    }
+    return SharedArray<T>(file_, reinterpret_cast<const T *>(data),
+                          expected_count);
+  }
+  std::size_t Bytes() const { return file_->Size(); }
+
+private:
+  bool FindSection(const std::uint32_t tag, const char *&data,
+                   std::size_t &bytes) const;
+
+  std::shared_ptr<const MappedFile> file_;
+};
+
+} // namespace s21
+
+#endif // NAVIGATOR_SRC_LIB_S21_SNAPSHOT_H_
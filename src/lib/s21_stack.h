@@ -2,12 +2,12 @@
 #define NAVIGATOR_SRC_LIB_S21_STACK_H_
 
 #include <initializer_list>
-#include <list>
 #include <utility>
+#include <vector>
 
 namespace s21 {
 
-template <class T, class Container = std::list<T>> class Stack {
+template <class T, class Container = std::vector<T>> class Stack {
 public:
   using value_type = T;
   using reference = T &;
@@ -37,11 +37,18 @@ public:
   size_type size() const { return cont_.size(); }
 
   void push(const_reference value) { cont_.push_back(value); }
+  void push(value_type &&value) { cont_.push_back(std::move(value)); }
   void pop() { cont_.pop_back(); }
   void swap(Stack &other) { cont_.swap(other.cont_); }
+  // Room for count items without allocating again.
+  void reserve(const size_type count) { cont_.reserve(count); }
+  void clear() { cont_.clear(); }
 
+  template <class... Args> void emplace(Args &&...args) {
+    cont_.emplace_back(std::forward<Args>(args)...);
+  }
   template <class... Args> void emplace_front(Args &&...args) {
-    cont_.emplace_back(args...);
+    cont_.emplace_back(std::forward<Args>(args)...);
   }
 
 private:
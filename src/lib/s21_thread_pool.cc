@@ -0,0 +1,110 @@
+#include "s21_thread_pool.h"
+
+#include <algorithm>
+
+namespace s21 {
+
+ThreadPool::ThreadPool(int threads) {
+  if (threads <= 0) {
+    threads = HardwareThreads();
+  }
+  for (int worker = 1; worker < threads; ++worker) {
+    threads_.emplace_back(&ThreadPool::WorkerLoop, this, worker);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread &thread : threads_) {
+    thread.join();
+  }
+}
+
+int ThreadPool::HardwareThreads() {
+  return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+void ThreadPool::ParallelFor(std::size_t count, const Task &task,
+                             std::size_t grain) {
+  if (count == 0) {
+    return;
+  }
+  grain = std::max<std::size_t>(grain, 1);
+  if (threads_.empty() || count <= grain) {
+    for (std::size_t index = 0; index < count; ++index) {
+      task(index, 0);
+    }
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    count_ = count;
+    grain_ = grain;
+    next_.store(0);
+    error_ = nullptr;
+    active_ = static_cast<int>(threads_.size());
+    ++generation_;
+  }
+  wake_.notify_all();
+  RunChunks(0);
+  std::exception_ptr error;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return active_ == 0; });
+    task_ = nullptr;
+    error = error_;
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void ThreadPool::WorkerLoop(int worker) {
+  std::size_t seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [this, seen] { return stopping_ || generation_ != seen; });
+      if (stopping_) {
+        return;
+      }
+      seen = generation_;
+    }
+    RunChunks(worker);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--active_ == 0) {
+        done_.notify_one();
+      }
+    }
+  }
+}
+
+void ThreadPool::RunChunks(int worker) {
+  while (true) {
+    std::size_t first = next_.fetch_add(grain_);
+    if (first >= count_) {
+      return;
+    }
+    std::size_t last = std::min(count_, first + grain_);
+    try {
+      for (std::size_t index = first; index < last; ++index) {
+        (*task_)(index, worker);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+      // Drain the remaining indices so every worker stops early.
+      next_.store(count_);
+    }
+  }
+}
+
+} // namespace s21
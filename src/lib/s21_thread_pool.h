@@ -0,0 +1,57 @@
+#ifndef NAVIGATOR_SRC_LIB_S21_THREAD_POOL_H_
+#define NAVIGATOR_SRC_LIB_S21_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace s21 {
+
+// Fixed set of worker threads for data-parallel loops. The calling thread
+// takes part as worker 0, so a pool of size 1 runs everything inline.
+class ThreadPool {
+public:
+  using Task = std::function<void(std::size_t index, int worker)>;
+
+  // threads <= 0 means one worker per hardware thread.
+  explicit ThreadPool(int threads = 0);
+  ThreadPool(const ThreadPool &other) = delete;
+  ThreadPool &operator=(const ThreadPool &other) = delete;
+  ~ThreadPool();
+
+  int Size() const { return static_cast<int>(threads_.size()) + 1; }
+
+  // Calls task(index, worker) for every index in [0, count), handing out
+  // indices in chunks of grain, and returns once all calls have finished.
+  // The first exception thrown by a task is rethrown here.
+  void ParallelFor(std::size_t count, const Task &task, std::size_t grain = 1);
+
+  static int HardwareThreads();
+
+private:
+  void WorkerLoop(int worker);
+  void RunChunks(int worker);
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  std::size_t generation_ = 0;
+  bool stopping_ = false;
+  int active_ = 0;
+
+  const Task *task_ = nullptr;
+  std::size_t count_ = 0;
+  std::size_t grain_ = 1;
+  std::atomic<std::size_t> next_{0};
+  std::exception_ptr error_;
+};
+
+} // namespace s21
+
+#endif // NAVIGATOR_SRC_LIB_S21_THREAD_POOL_H_
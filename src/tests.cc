@@ -1,10 +1,25 @@
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "lib/s21_bit_matrix.h"
+#include "lib/s21_contraction_hierarchy.h"
+#include "lib/s21_disjoint_set.h"
 #include "lib/s21_graph.h"
 #include "lib/s21_graph_algorithms.h"
+#include "lib/s21_indexed_heap.h"
+#include "lib/s21_landmarks.h"
+#include "lib/s21_next_hop_matrix.h"
 #include "lib/s21_queue.h"
+#include "lib/s21_snapshot.h"
 #include "lib/s21_stack.h"
+#include "lib/s21_thread_pool.h"
 #include "gtest/gtest.h"
 
 using s21::Graph;
@@ -88,6 +103,170 @@ TEST(LoadGraphFromFile, WeightedDirectedGraph) {
     }
 }
 
+TEST(LoadGraphFromFile, SparseStorage) {
+  Graph test_graph;
+  test_graph.LoadGraphFromFile("tests/examples/unweighted_directed_graph.txt");
+  EXPECT_EQ(test_graph.Size(), 5);
+  EXPECT_EQ(test_graph.EdgeCount(), 12u);
+  vector<int> expected = {0, 2, 4};
+  EXPECT_EQ(test_graph.Neighbors(4), expected);
+  std::reverse(expected.begin(), expected.end());
+  EXPECT_EQ(test_graph.NeighborsFromEnd(4), expected);
+  EXPECT_EQ(test_graph.GetEdgeWeight(4, 1), 0);
+  EXPECT_ANY_THROW(test_graph.GetEdgeWeight(5, 0));
+}
+
+TEST(OutEdges, ForwardAndReverse) {
+  Graph test_graph;
+  test_graph.LoadGraphFromFile("tests/examples/uug.txt");
+  vector<int> targets;
+  vector<int> weights;
+  for (s21::Edge edge : test_graph.OutEdges(0)) {
+    targets.push_back(edge.to);
+    weights.push_back(edge.weight);
+  }
+  EXPECT_EQ(targets, vector<int>({1, 4}));
+  EXPECT_EQ(weights, vector<int>({2, 20}));
+  targets.clear();
+  for (s21::Edge edge : test_graph.OutEdgesFromEnd(2)) {
+    targets.push_back(edge.to);
+  }
+  EXPECT_EQ(targets, vector<int>({3, 1}));
+  EXPECT_EQ(test_graph.OutEdges(4).size(), 2u);
+}
+
+TEST(LoadGraphFromFile, LoadStats) {
+  Graph test_graph;
+  test_graph.LoadGraphFromFile("tests/examples/wug2.txt");
+  EXPECT_EQ(test_graph.GetEdgeWeight(1, 2), 35);
+  EXPECT_EQ(test_graph.GetEdgeWeight(3, 2), 30);
+  EXPECT_GT(test_graph.LastLoadStats().bytes, 0u);
+  EXPECT_GE(test_graph.LastLoadStats().MegabytesPerSecond(), 0.0);
+}
+
+TEST(LoadGraphFromFile, MissingFile) {
+  Graph test_graph;
+  EXPECT_ANY_THROW(test_graph.LoadGraphFromFile("tests/no_such_file.txt"));
+}
+
+TEST(LoadGraphFromFile, DimacsAndEdgeList) {
+  Graph matrix;
+  Graph dimacs;
+  Graph edge_list;
+  matrix.LoadGraphFromFile("tests/examples/dwg2.txt");
+  dimacs.LoadGraphFromFile("tests/examples/road.gr");
+  edge_list.LoadGraphFromFile("tests/examples/road.el");
+  ASSERT_EQ(dimacs.Size(), matrix.Size());
+  ASSERT_EQ(edge_list.Size(), matrix.Size());
+  EXPECT_EQ(dimacs.EdgeCount(), matrix.EdgeCount());
+  for (int i = 0; i < matrix.Size(); ++i) {
+    for (int j = 0; j < matrix.Size(); ++j) {
+      EXPECT_EQ(dimacs.GetEdgeWeight(i, j), matrix.GetEdgeWeight(i, j));
+      EXPECT_EQ(edge_list.GetEdgeWeight(i, j), matrix.GetEdgeWeight(i, j));
+    }
+  }
+}
+
+TEST(LoadGraphFromFile, DetectEdgeListByContent) {
+  Graph test_graph;
+  test_graph.LoadGraphFromFile("tests/examples/cycle_edges.txt");
+  EXPECT_EQ(test_graph.Size(), 3);
+  EXPECT_EQ(test_graph.GetEdgeWeight(2, 0), 1);
+  EXPECT_EQ(GraphAlgorithms::GetShortestPathBetweenVertices(test_graph, 1, 3),
+            2);
+}
+
+TEST(LoadGraphFromFile, DimacsArcCountMismatch) {
+  Graph test_graph;
+  EXPECT_ANY_THROW(test_graph.LoadGraphFromFile("tests/dimacs_arc_count.gr"));
+}
+
+TEST(LoadGraphFromFile, HugeHeaderCountsAreWrongFiles) {
+  Graph test_graph;
+  EXPECT_THROW(test_graph.LoadGraphFromFile("tests/dimacs_huge_header.gr"),
+               const char *);
+  EXPECT_THROW(test_graph.LoadGraphFromFile("tests/matrix_huge_header.txt"),
+               const char *);
+}
+
+TEST(LoadBinary, RoundTrip) {
+  Graph text_graph;
+  text_graph.LoadGraphFromFile("tests/examples/weighted_undirected_graph.txt");
+  text_graph.SaveBinary("tests/wug.snapshot");
+  Graph binary_graph;
+  binary_graph.LoadBinary("tests/wug.snapshot");
+  Graph detected_graph;
+  detected_graph.LoadGraphFromFile("tests/wug.snapshot");
+  std::remove("tests/wug.snapshot");
+  ASSERT_EQ(binary_graph.Size(), text_graph.Size());
+  ASSERT_EQ(binary_graph.EdgeCount(), text_graph.EdgeCount());
+  for (int i = 0; i < text_graph.Size(); ++i) {
+    for (int j = 0; j < text_graph.Size(); ++j) {
+      EXPECT_EQ(binary_graph.GetEdgeWeight(i, j),
+                text_graph.GetEdgeWeight(i, j));
+      EXPECT_EQ(detected_graph.GetEdgeWeight(i, j),
+                text_graph.GetEdgeWeight(i, j));
+    }
+  }
+  Graph copy = binary_graph;
+  EXPECT_EQ(GraphAlgorithms::GetShortestPathBetweenVertices(copy, 1, 7), 100);
+}
+
+TEST(LoadBinary, RejectsTextAndCorruptFiles) {
+  Graph test_graph;
+  EXPECT_ANY_THROW(test_graph.LoadBinary("tests/examples/wug2.txt"));
+  test_graph.LoadGraphFromFile("tests/examples/wug2.txt");
+  test_graph.SaveBinary("tests/wug2.snapshot");
+  {
+    std::fstream file("tests/wug2.snapshot",
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(3 * 4096);
+    file.put(7);
+  }
+  Graph corrupt;
+  EXPECT_ANY_THROW(corrupt.LoadBinary("tests/wug2.snapshot"));
+  EXPECT_NO_THROW(corrupt.LoadBinary("tests/wug2.snapshot", false));
+  std::remove("tests/wug2.snapshot");
+}
+
+TEST(LoadBinary, RejectsOutOfRangeTarget) {
+  Graph test_graph;
+  test_graph.LoadGraphFromFile("tests/examples/wug2.txt");
+  test_graph.SaveBinary("tests/wug2_target.snapshot");
+  {
+    // The targets section starts on the third page.
+    std::fstream file("tests/wug2_target.snapshot",
+                      std::ios::in | std::ios::out | std::ios::binary);
+    int target = test_graph.Size();
+    file.seekp(2 * 4096);
+    file.write(reinterpret_cast<const char *>(&target), sizeof(target));
+  }
+  Graph corrupt;
+  EXPECT_ANY_THROW(corrupt.LoadBinary("tests/wug2_target.snapshot", false));
+  EXPECT_ANY_THROW(corrupt.LoadBinary("tests/wug2_target.snapshot"));
+  std::remove("tests/wug2_target.snapshot");
+}
+
+TEST(LoadBinary, RejectsOverflowingEdgeCount) {
+  // 4 * (2^62 + 1) wraps to 4 bytes, the size of each one-edge section.
+  const std::uint64_t edges = (1ULL << 62) + 1;
+  std::size_t offsets[] = {0, static_cast<std::size_t>(edges)};
+  int ends[] = {0};
+  s21::SnapshotWriter writer(s21::kGraphSnapshotKind,
+                            s21::kGraphSnapshotVersion);
+  writer.SetValue(0, 1);
+  writer.SetValue(1, edges);
+  for (std::uint32_t tag = 1; tag <= 6; tag += 3) {
+    writer.AddSection(tag, offsets, 2);
+    writer.AddSection(tag + 1, ends, 1);
+    writer.AddSection(tag + 2, ends, 1);
+  }
+  writer.Write("tests/overflow.snapshot");
+  Graph graph;
+  EXPECT_ANY_THROW(graph.LoadBinary("tests/overflow.snapshot", false));
+  std::remove("tests/overflow.snapshot");
+}
+
 TEST(stack, create) {
   s21::Stack<int> a;
   s21::Stack<int> b({1, 2, 3, 4});
@@ -178,6 +357,68 @@ TEST(queue, operations3) {
   ASSERT_EQ(d.back(), 5);
 }
 
+TEST(queue, WrapsAndGrows) {
+  s21::Queue<int> a;
+  a.reserve(8);
+  int next = 0;
+  int expected = 0;
+  // Keep the ring partly full while the head walks around it, then grow
+  // it with the items split across the end of the block.
+  for (int round = 0; round < 20; ++round) {
+    for (int i = 0; i < 5; ++i) {
+      a.push(next++);
+    }
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_EQ(a.front(), expected++);
+      a.pop();
+    }
+  }
+  ASSERT_EQ(a.size(), 20u);
+  ASSERT_EQ(a.front(), expected);
+  ASSERT_EQ(a.back(), next - 1);
+  s21::Queue<int> b(a);
+  while (!b.empty()) {
+    ASSERT_EQ(b.front(), expected++);
+    b.pop();
+  }
+}
+
+TEST(queue, EmplaceForwards) {
+  s21::Queue<std::unique_ptr<int>> a;
+  a.emplace(new int(4));
+  a.push(std::unique_ptr<int>(new int(5)));
+  s21::Queue<std::unique_ptr<int>> b(std::move(a));
+  ASSERT_EQ(*b.front(), 4);
+  ASSERT_EQ(*b.back(), 5);
+
+  s21::Stack<std::pair<int, std::string>> c;
+  c.reserve(2);
+  c.emplace(1, "one");
+  c.emplace(2, std::string(3, 'x'));
+  ASSERT_EQ(c.top().second, "xxx");
+  c.pop();
+  ASSERT_EQ(c.top().first, 1);
+}
+
+TEST(IndexedHeap, DecreaseKeyOrder) {
+  s21::IndexedHeap<int> heap(6);
+  heap.push(0, 50);
+  heap.push(1, 40);
+  heap.push(2, 30);
+  heap.push(3, 20);
+  heap.push(4, 10);
+  EXPECT_TRUE(heap.push_or_decrease(0, 5));
+  EXPECT_FALSE(heap.push_or_decrease(1, 45));
+  EXPECT_TRUE(heap.push_or_decrease(5, 25));
+  vector<int> order;
+  while (!heap.empty()) {
+    order.push_back(heap.top());
+    heap.pop();
+  }
+  EXPECT_EQ(order, vector<int>({0, 4, 3, 5, 2, 1}));
+  EXPECT_FALSE(heap.contains(0));
+}
+
 TEST(DepthFirstSearchTest, udg2) {
   Graph test_graph;
   test_graph.LoadGraphFromFile("tests/examples/undirected_graph.txt");
@@ -251,6 +492,104 @@ TEST(BreadthFirstSearch, wug1) {
   ASSERT_TRUE(CompareVectorsContent(expected, actual));
 }
 
+TEST(BreadthFirstSearch, DirectionOptimizingTree) {
+  const char *path = "tests/bfs_tree.el";
+  const int size = 3000;
+  std::srand(5);
+  {
+    std::ofstream out(path);
+    // The last vertices get no in-arcs and stay unreachable from 0.
+    for (int from = 0; from < size; ++from) {
+      for (int k = 0; k < 8; ++k) {
+        out << from << " " << std::rand() % (size - 10) << " 1\n";
+      }
+    }
+  }
+  Graph test_graph;
+  test_graph.LoadGraphFromFile(path);
+  std::remove(path);
+
+  s21::BfsTree tree = GraphAlgorithms::GetBreadthFirstTree(test_graph, 0);
+  vector<int> level(size, -1);
+  level[0] = 0;
+  vector<int> queue = {0};
+  for (std::size_t head = 0; head < queue.size(); ++head) {
+    for (s21::Edge edge : test_graph.OutEdges(queue[head])) {
+      if (level[edge.to] == -1) {
+        level[edge.to] = level[queue[head]] + 1;
+        queue.push_back(edge.to);
+      }
+    }
+  }
+  ASSERT_EQ(tree.level, level);
+  ASSERT_EQ(tree.order.size(), queue.size());
+  for (std::size_t i = 1; i < tree.order.size(); ++i) {
+    int previous = tree.order[i - 1] - 1;
+    int vertex = tree.order[i] - 1;
+    EXPECT_TRUE(level[previous] < level[vertex] ||
+                (level[previous] == level[vertex] && previous < vertex));
+  }
+  for (int vertex = 1; vertex < size; ++vertex) {
+    if (level[vertex] == -1) {
+      EXPECT_EQ(tree.parent[vertex], 0);
+      continue;
+    }
+    int parent = 0;
+    for (s21::Edge edge : test_graph.InEdges(vertex)) {
+      if (level[edge.to] == level[vertex] - 1) {
+        parent = edge.to + 1;
+        break;
+      }
+    }
+    EXPECT_EQ(tree.parent[vertex], parent);
+  }
+
+  test_graph.LoadGraphFromFile("tests/examples/undirected_graph.txt");
+  tree = GraphAlgorithms::GetBreadthFirstTree(test_graph, 0);
+  vector<int> sorted = GraphAlgorithms::BreadthFirstSearch(test_graph, 0);
+  std::sort(sorted.begin(), sorted.end());
+  vector<int> reached = tree.order;
+  std::sort(reached.begin(), reached.end());
+  EXPECT_EQ(reached, sorted);
+  EXPECT_ANY_THROW(GraphAlgorithms::GetBreadthFirstTree(test_graph, -1));
+}
+
+TEST(BreadthFirstSearch, MultiSourceLevels) {
+  const char *path = "tests/ms_bfs.el";
+  const int size = 1500;
+  std::srand(8);
+  {
+    std::ofstream out(path);
+    for (int from = 0; from < size; ++from) {
+      for (int k = 0; k < 3; ++k) {
+        out << from << " " << std::rand() % size << " 1\n";
+      }
+    }
+  }
+  Graph test_graph;
+  test_graph.LoadGraphFromFile(path);
+  std::remove(path);
+
+  vector<int> starts;
+  for (int i = 0; i < 100; ++i) {
+    starts.push_back(std::rand() % size);
+  }
+  starts.push_back(starts.front());
+  for (int threads : {1, 3}) {
+    vector<vector<int>> levels =
+        GraphAlgorithms::GetBreadthFirstLevels(test_graph, starts, threads);
+    ASSERT_EQ(levels.size(), starts.size());
+    for (std::size_t i = 0; i < starts.size(); ++i) {
+      EXPECT_EQ(levels[i],
+                GraphAlgorithms::GetBreadthFirstTree(test_graph, starts[i])
+                    .level);
+    }
+  }
+  EXPECT_TRUE(GraphAlgorithms::GetBreadthFirstLevels(test_graph, {}).empty());
+  EXPECT_ANY_THROW(
+      GraphAlgorithms::GetBreadthFirstLevels(test_graph, {size}));
+}
+
 TEST(GetShortestPathBetweenVertices, UnweightedDirectedGraph) {
   Graph graph;
   graph.LoadGraphFromFile("tests/examples/unweighted_directed_graph.txt");
@@ -270,6 +609,232 @@ TEST(GetShortestPathBetweenVertices, dwg2) {
   EXPECT_EQ(GraphAlgorithms::GetShortestPathBetweenVertices(graph, 1, 4), 2);
 }
 
+TEST(GetShortestPathBetweenVertices, uug) {
+  Graph graph;
+  graph.LoadGraphFromFile("tests/examples/uug.txt");
+  EXPECT_EQ(GraphAlgorithms::GetShortestPathBetweenVertices(graph, 1, 5), 11);
+  EXPECT_EQ(GraphAlgorithms::GetShortestPathBetweenVertices(graph, 5, 2), 9);
+  EXPECT_EQ(GraphAlgorithms::GetShortestPathBetweenVertices(graph, 3, 3), 0);
+}
+
+TEST(GetShortestPathBetweenVertices, Unreachable) {
+  Graph graph;
+  graph.LoadGraphFromFile("tests/examples/two_components.el");
+  EXPECT_EQ(GraphAlgorithms::GetShortestPathBetweenVertices(graph, 1, 2), 3);
+  EXPECT_EQ(GraphAlgorithms::GetShortestPathBetweenVertices(graph, 1, 4),
+            s21::kInf);
+}
+
+TEST(GetShortestPathBetweenVertices, BidirectionalMatchesForward) {
+  const char *files[] = {"tests/examples/uug.txt", "tests/examples/dwg.txt",
+                         "tests/examples/dwg2.txt",
+                         "tests/examples/weighted_undirected_graph.txt",
+                         "tests/examples/unweighted_directed_graph.txt",
+                         "tests/examples/two_components.el"};
+  for (const char *file : files) {
+    Graph graph;
+    graph.LoadGraphFromFile(file);
+    for (int i = 1; i <= graph.Size(); ++i) {
+      for (int j = 1; j <= graph.Size(); ++j) {
+        EXPECT_EQ(GraphAlgorithms::GetShortestPathBetweenVertices(
+                      graph, i, j, s21::SearchMode::kBidirectional),
+                  GraphAlgorithms::GetShortestPathBetweenVertices(graph, i, j))
+            << file << " " << i << " -> " << j;
+      }
+    }
+  }
+}
+
+TEST(GetShortestPathBetweenVertices, BatchMatchesSingleQueries) {
+  const char *files[] = {"tests/examples/dwg.txt",
+                         "tests/examples/weighted_undirected_graph.txt",
+                         "tests/examples/two_components.el"};
+  std::srand(13);
+  for (const char *file : files) {
+    Graph graph;
+    graph.LoadGraphFromFile(file);
+    vector<s21::PathQuery> queries;
+    for (int i = 0; i < 200; ++i) {
+      queries.push_back({1 + std::rand() % graph.Size(),
+                         1 + std::rand() % graph.Size()});
+    }
+    for (int threads : {1, 3}) {
+      vector<int> distances =
+          GraphAlgorithms::GetShortestPathsBetweenPairs(graph, queries,
+                                                        threads);
+      ASSERT_EQ(distances.size(), queries.size());
+      for (std::size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(distances[i],
+                  GraphAlgorithms::GetShortestPathBetweenVertices(
+                      graph, queries[i].source, queries[i].target))
+            << file << " " << queries[i].source << " -> "
+            << queries[i].target;
+      }
+    }
+    EXPECT_TRUE(GraphAlgorithms::GetShortestPathsBetweenPairs(graph, {})
+                    .empty());
+    EXPECT_ANY_THROW(
+        GraphAlgorithms::GetShortestPathsBetweenPairs(graph, {{1, 0}}));
+  }
+}
+
+TEST(GetShortestPathBetweenVertices, TreeGivesEveryPath) {
+  const char *files[] = {"tests/examples/dwg.txt",
+                         "tests/examples/weighted_undirected_graph.txt",
+                         "tests/examples/two_components.el"};
+  for (const char *file : files) {
+    Graph graph;
+    graph.LoadGraphFromFile(file);
+    for (int source = 1; source <= graph.Size(); ++source) {
+      s21::ShortestPathTree tree =
+          GraphAlgorithms::GetShortestPathTree(graph, source);
+      ASSERT_EQ(tree.Source(), source);
+      ASSERT_EQ(tree.Size(), graph.Size());
+      EXPECT_EQ(tree.Predecessor(source), 0);
+      for (int target = 1; target <= graph.Size(); ++target) {
+        int expected = target == source
+                           ? 0
+                           : GraphAlgorithms::GetShortestPathBetweenVertices(
+                                 graph, source, target);
+        s21::ShortestPath path = tree.Path(target);
+        EXPECT_EQ(tree.Distance(target), expected) << file;
+        EXPECT_EQ(path.distance, expected) << file;
+        if (expected == s21::kInf) {
+          EXPECT_TRUE(path.vertices.empty());
+          EXPECT_EQ(tree.Predecessor(target), 0);
+          continue;
+        }
+        ASSERT_FALSE(path.vertices.empty());
+        EXPECT_EQ(path.vertices.front(), source);
+        EXPECT_EQ(path.vertices.back(), target);
+        int length = 0;
+        for (std::size_t i = 1; i < path.vertices.size(); ++i) {
+          int weight = graph.GetEdgeWeight(path.vertices[i - 1] - 1,
+                                           path.vertices[i] - 1);
+          ASSERT_GT(weight, 0);
+          length += weight;
+        }
+        EXPECT_EQ(length, expected) << file;
+      }
+    }
+    EXPECT_ANY_THROW(GraphAlgorithms::GetShortestPathTree(graph, 0));
+  }
+}
+
+TEST(GetShortestPathBetweenVertices, LandmarksMatchForward) {
+  const char *files[] = {"tests/examples/uug.txt", "tests/examples/dwg.txt",
+                         "tests/examples/weighted_undirected_graph.txt",
+                         "tests/examples/unweighted_directed_graph.txt",
+                         "tests/examples/two_components.el"};
+  for (const char *file : files) {
+    Graph graph;
+    graph.LoadGraphFromFile(file);
+    s21::Landmarks landmarks = s21::Landmarks::Build(graph, 3);
+    for (int i = 1; i <= graph.Size(); ++i) {
+      for (int j = 1; j <= graph.Size(); ++j) {
+        int expected =
+            GraphAlgorithms::GetShortestPathBetweenVertices(graph, i, j);
+        EXPECT_LE(landmarks.LowerBound(i - 1, j - 1), expected);
+        EXPECT_EQ(GraphAlgorithms::GetShortestPathBetweenVertices(
+                      graph, landmarks, i, j),
+                  expected)
+            << file << " " << i << " -> " << j;
+      }
+    }
+  }
+}
+
+TEST(Landmarks, SaveAndLoad) {
+  Graph graph;
+  graph.LoadGraphFromFile("tests/examples/weighted_undirected_graph.txt");
+  s21::Landmarks built = s21::Landmarks::Build(graph, 4);
+  built.Save("tests/wug.landmarks");
+  s21::Landmarks loaded;
+  loaded.Load("tests/wug.landmarks", graph);
+  EXPECT_EQ(loaded.Vertices(), built.Vertices());
+  EXPECT_EQ(loaded.LowerBound(0, 6), built.LowerBound(0, 6));
+  Graph other;
+  other.LoadGraphFromFile("tests/examples/uug.txt");
+  EXPECT_ANY_THROW(loaded.Load("tests/wug.landmarks", other));
+  std::remove("tests/wug.landmarks");
+}
+
+TEST(ContractionHierarchy, MatchesDijkstra) {
+  const char *files[] = {"tests/examples/uug.txt", "tests/examples/dwg.txt",
+                         "tests/examples/dwg2.txt",
+                         "tests/examples/weighted_undirected_graph.txt",
+                         "tests/examples/unweighted_directed_graph.txt",
+                         "tests/examples/two_components.el"};
+  for (const char *file : files) {
+    Graph graph;
+    graph.LoadGraphFromFile(file);
+    auto hierarchy = s21::ContractionHierarchy::Build(graph, 2);
+    s21::ContractionHierarchy::Query query(hierarchy);
+    for (int i = 1; i <= graph.Size(); ++i) {
+      for (int j = 1; j <= graph.Size(); ++j) {
+        int expected =
+            GraphAlgorithms::GetShortestPathBetweenVertices(graph, i, j);
+        s21::ShortestPath path = query.Path(i, j);
+        ASSERT_EQ(path.distance, expected) << file << " " << i << " -> " << j;
+        if (expected == s21::kInf) {
+          EXPECT_TRUE(path.vertices.empty());
+          continue;
+        }
+        ASSERT_FALSE(path.vertices.empty());
+        EXPECT_EQ(path.vertices.front(), i);
+        EXPECT_EQ(path.vertices.back(), j);
+        int length = 0;
+        for (std::size_t k = 1; k < path.vertices.size(); ++k) {
+          length += graph.GetEdgeWeight(path.vertices[k - 1] - 1,
+                                        path.vertices[k] - 1);
+        }
+        EXPECT_EQ(length, expected);
+      }
+    }
+  }
+}
+
+TEST(ContractionHierarchy, SaveAndLoad) {
+  Graph graph;
+  graph.LoadGraphFromFile("tests/examples/weighted_undirected_graph.txt");
+  auto built = s21::ContractionHierarchy::Build(graph);
+  built.Save("tests/wug.hierarchy");
+  s21::ContractionHierarchy loaded;
+  loaded.Load("tests/wug.hierarchy", graph);
+  std::remove("tests/wug.hierarchy");
+  EXPECT_EQ(loaded.ShortcutCount(), built.ShortcutCount());
+  for (int i = 1; i <= graph.Size(); ++i) {
+    EXPECT_EQ(loaded.Distance(1, i), built.Distance(1, i));
+    EXPECT_EQ(loaded.Path(i, 7).vertices, built.Path(i, 7).vertices);
+  }
+}
+
+TEST(ThreadPool, ParallelFor) {
+  s21::ThreadPool pool(4);
+  vector<int> hits(1000, 0);
+  pool.ParallelFor(hits.size(), [&hits](std::size_t i, int) { hits[i] += 1; },
+                   7);
+  EXPECT_EQ(std::count(hits.begin(), hits.end(), 1), 1000);
+  EXPECT_ANY_THROW(pool.ParallelFor(10, [](std::size_t i, int) {
+    if (i == 3) {
+      throw "task failed";
+    }
+  }));
+}
+
+TEST(Graph, InEdges) {
+  Graph graph;
+  graph.LoadGraphFromFile("tests/examples/dwg2.txt");
+  vector<int> sources;
+  vector<int> weights;
+  for (s21::Edge edge : graph.InEdges(0)) {
+    sources.push_back(edge.to);
+    weights.push_back(edge.weight);
+  }
+  EXPECT_EQ(sources, vector<int>({2, 3}));
+  EXPECT_EQ(weights, vector<int>({1, 5}));
+}
+
 TEST(GetShortestPathsBetweenAllVertices, udg1) {
   Graph graph;
   graph.LoadGraphFromFile("tests/examples/unweighted_directed_graph.txt");
@@ -295,6 +860,176 @@ TEST(GetShortestPathsBetweenAllVertices, uug) {
   ASSERT_EQ(actual[0][4], 11);
 }
 
+TEST(GetShortestPathsBetweenAllVertices, BlockedMatchesTextbook) {
+  // 100 vertices span several tiles plus padding.
+  const int size = 100;
+  std::srand(21);
+  {
+    std::ofstream file("tests/random.el");
+    for (int i = 0; i < 4 * size; ++i) {
+      file << std::rand() % size << " " << std::rand() % size << " "
+           << 1 + std::rand() % 50 << "\n";
+    }
+  }
+  Graph graph;
+  graph.LoadGraphFromFile("tests/random.el");
+  std::remove("tests/random.el");
+  int count = graph.Size();
+  vector<vector<long long>> expected(count,
+                                     vector<long long>(count, s21::kInf));
+  for (int i = 0; i < count; ++i) {
+    for (s21::Edge edge : graph.OutEdges(i)) {
+      expected[i][edge.to] = edge.weight;
+    }
+  }
+  for (int k = 0; k < count; ++k) {
+    for (int i = 0; i < count; ++i) {
+      for (int j = 0; j < count; ++j) {
+        expected[i][j] =
+            std::min(expected[i][j], expected[i][k] + expected[k][j]);
+      }
+    }
+  }
+  vector<vector<int>> actual =
+      GraphAlgorithms::GetShortestPathsBetweenAllVertices(graph);
+  ASSERT_EQ(static_cast<int>(actual.size()), count);
+  for (int i = 0; i < count; ++i) {
+    for (int j = 0; j < count; ++j) {
+      ASSERT_EQ(actual[i][j], std::min<long long>(expected[i][j], s21::kInf))
+          << i << " -> " << j;
+    }
+  }
+}
+
+TEST(GetShortestPathsBetweenAllVertices, ParallelMethodsAgree) {
+  const char *files[] = {"tests/examples/uug.txt", "tests/examples/dwg2.txt",
+                         "tests/examples/weighted_undirected_graph.txt",
+                         "tests/examples/unweighted_directed_graph.txt",
+                         "tests/examples/two_components.el"};
+  for (const char *file : files) {
+    Graph graph;
+    graph.LoadGraphFromFile(file);
+    vector<vector<int>> expected =
+        GraphAlgorithms::GetShortestPathsBetweenAllVertices(graph);
+    EXPECT_EQ(GraphAlgorithms::GetShortestPathsBetweenAllVertices(
+                  graph, 3, s21::AllPairsMethod::kJohnson),
+              expected)
+        << file;
+    EXPECT_EQ(GraphAlgorithms::GetShortestPathsBetweenAllVertices(
+                  graph, 3, s21::AllPairsMethod::kFloydWarshall),
+              expected)
+        << file;
+    EXPECT_EQ(GraphAlgorithms::GetShortestPathsBetweenAllVertices(graph, 3),
+              expected)
+        << file;
+  }
+}
+
+TEST(GetShortestPathsBetweenAllVertices, NextHopsUnpackPaths) {
+  const char *files[] = {"tests/examples/dwg.txt",
+                         "tests/examples/weighted_undirected_graph.txt",
+                         "tests/examples/two_components.el"};
+  for (const char *file : files) {
+    Graph graph;
+    graph.LoadGraphFromFile(file);
+    for (s21::AllPairsMethod method : {s21::AllPairsMethod::kFloydWarshall,
+                                       s21::AllPairsMethod::kJohnson}) {
+      s21::NextHopMatrix hops;
+      vector<vector<int>> distances =
+          GraphAlgorithms::GetShortestPathsBetweenAllVertices(graph, 2, method,
+                                                              hops);
+      ASSERT_EQ(hops.Size(), graph.Size());
+      EXPECT_TRUE(hops.IsNarrow());
+      for (int from = 1; from <= graph.Size(); ++from) {
+        for (int to = 1; to <= graph.Size(); ++to) {
+          vector<int> path = hops.Path(from, to);
+          int expected = distances[from - 1][to - 1];
+          if (expected == s21::kInf) {
+            EXPECT_TRUE(path.empty());
+            EXPECT_EQ(hops.Next(from, to), 0);
+            continue;
+          }
+          ASSERT_GE(path.size(), 2u) << file;
+          EXPECT_EQ(path.front(), from);
+          EXPECT_EQ(path.back(), to);
+          EXPECT_EQ(hops.Next(from, to), path[1]);
+          int length = 0;
+          for (std::size_t i = 1; i < path.size(); ++i) {
+            int weight =
+                graph.GetEdgeWeight(path[i - 1] - 1, path[i] - 1);
+            ASSERT_GT(weight, 0);
+            length += weight;
+          }
+          EXPECT_EQ(length, expected) << file << " " << from << " " << to;
+        }
+      }
+    }
+  }
+
+  Graph graph;
+  graph.LoadGraphFromFile("tests/examples/dwg.txt");
+  s21::NextHopMatrix hops;
+  GraphAlgorithms::GetShortestPathsBetweenAllVertices(
+      graph, 1, s21::AllPairsMethod::kAuto, hops);
+  hops.Save("tests/dwg.nexthop");
+  s21::NextHopMatrix loaded;
+  loaded.Load("tests/dwg.nexthop", graph);
+  for (int from = 1; from <= graph.Size(); ++from) {
+    for (int to = 1; to <= graph.Size(); ++to) {
+      EXPECT_EQ(loaded.Path(from, to), hops.Path(from, to));
+    }
+  }
+  Graph other;
+  other.LoadGraphFromFile("tests/examples/wug2.txt");
+  EXPECT_ANY_THROW(loaded.Load("tests/dwg.nexthop", other));
+  std::remove("tests/dwg.nexthop");
+  EXPECT_ANY_THROW(hops.Path(0, 1));
+}
+
+TEST(GetTransitiveClosure, MatchesAllPairs) {
+  const char *path = "tests/closure.el";
+  const int size = 150;
+  std::srand(21);
+  {
+    std::ofstream out(path);
+    // Two loosely joined halves, the second one unable to reach back.
+    for (int from = 0; from < size; ++from) {
+      int half = from < size / 2 ? 0 : size / 2;
+      out << from << " " << half + std::rand() % (size / 2) << " 1\n";
+      if (std::rand() % 10 == 0) {
+        out << from << " " << size / 2 + std::rand() % (size / 2) << " 1\n";
+      }
+    }
+  }
+  vector<const char *> files = {path, "tests/examples/undirected_graph.txt",
+                                "tests/examples/unweighted_directed_graph.txt",
+                                "tests/examples/two_components.el"};
+  for (const char *file : files) {
+    Graph test_graph;
+    test_graph.LoadGraphFromFile(file);
+    vector<vector<int>> distances =
+        GraphAlgorithms::GetShortestPathsBetweenAllVertices(test_graph);
+    for (int threads : {1, 3}) {
+      s21::BitMatrix reach =
+          GraphAlgorithms::GetTransitiveClosure(test_graph, threads);
+      ASSERT_EQ(reach.Size(), test_graph.Size());
+      for (int i = 0; i < test_graph.Size(); ++i) {
+        for (int j = 0; j < test_graph.Size(); ++j) {
+          EXPECT_EQ(reach(i, j), distances[i][j] != s21::kInf)
+              << file << " " << i << " " << j;
+        }
+      }
+    }
+    s21::BitMatrix adjacency = s21::BitMatrix::FromGraph(test_graph);
+    for (int vertex = 0; vertex < test_graph.Size(); ++vertex) {
+      EXPECT_EQ(adjacency.Neighbors(vertex), test_graph.Neighbors(vertex));
+      EXPECT_EQ(adjacency.Count(vertex),
+                static_cast<int>(test_graph.OutEdges(vertex).size()));
+    }
+  }
+  std::remove(path);
+}
+
 TEST(GetLeastSpanningTree, UnweightedDirectedGraph) {
   Graph graph;
   graph.LoadGraphFromFile("tests/examples/unweighted_directed_graph.txt");
@@ -310,6 +1045,83 @@ TEST(GetLeastSpanningTree, UnweightedDirectedGraph) {
   EXPECT_EQ(actual_result, expected_result);
 }
 
+TEST(GetMinimumSpanningForest, PrimMatchesKruskal) {
+  const char *files[] = {"tests/examples/uug.txt", "tests/examples/dwg2.txt",
+                         "tests/examples/weighted_undirected_graph.txt",
+                         "tests/examples/unweighted_directed_graph.txt"};
+  for (const char *file : files) {
+    Graph graph;
+    graph.LoadGraphFromFile(file);
+    s21::SpanningForest prim = GraphAlgorithms::GetMinimumSpanningForest(
+        graph, s21::SpanningTreeMethod::kPrim);
+    s21::SpanningForest kruskal = GraphAlgorithms::GetMinimumSpanningForest(
+        graph, s21::SpanningTreeMethod::kKruskal);
+    s21::SpanningForest boruvka = GraphAlgorithms::GetMinimumSpanningForest(
+        graph, s21::SpanningTreeMethod::kBoruvka, 3);
+    EXPECT_EQ(prim.weight, kruskal.weight) << file;
+    EXPECT_EQ(boruvka.weight, kruskal.weight) << file;
+    EXPECT_EQ(static_cast<int>(prim.edges.size()), graph.Size() - 1) << file;
+    EXPECT_EQ(static_cast<int>(boruvka.edges.size()), graph.Size() - 1)
+        << file;
+    EXPECT_EQ(static_cast<int>(kruskal.edges.size()), graph.Size() - 1)
+        << file;
+  }
+}
+
+TEST(GetMinimumSpanningForest, Disconnected) {
+  Graph graph;
+  graph.LoadGraphFromFile("tests/examples/two_components.el");
+  for (auto method :
+       {s21::SpanningTreeMethod::kPrim, s21::SpanningTreeMethod::kKruskal,
+        s21::SpanningTreeMethod::kBoruvka}) {
+    s21::SpanningForest forest =
+        GraphAlgorithms::GetMinimumSpanningForest(graph, method);
+    ASSERT_EQ(forest.edges.size(), 2u);
+    EXPECT_EQ(forest.weight, 7);
+    for (const s21::TreeEdge &edge : forest.edges) {
+      EXPECT_EQ(graph.GetEdgeWeight(edge.from - 1, edge.to - 1), edge.weight);
+    }
+  }
+}
+
+TEST(GetMinimumSpanningForest, ParallelBoruvka) {
+  // Enough arcs for several chunks per round, and a few isolated vertices.
+  const int size = 3000;
+  std::srand(13);
+  {
+    std::ofstream file("tests/random.el");
+    for (int i = 0; i < 6 * size; ++i) {
+      file << std::rand() % (size - 5) << " " << std::rand() % (size - 5) << " "
+           << 1 + std::rand() % 20 << "\n";
+    }
+    file << size - 1 << " " << size - 1 << " 1\n";
+  }
+  Graph graph;
+  graph.LoadGraphFromFile("tests/random.el");
+  std::remove("tests/random.el");
+  s21::SpanningForest kruskal =
+      GraphAlgorithms::GetMinimumSpanningForest(graph);
+  s21::SpanningForest boruvka = GraphAlgorithms::GetMinimumSpanningForest(
+      graph, s21::SpanningTreeMethod::kBoruvka, 4);
+  EXPECT_EQ(boruvka.weight, kruskal.weight);
+  EXPECT_EQ(boruvka.edges.size(), kruskal.edges.size());
+  s21::DisjointSet set(graph.Size());
+  for (const s21::TreeEdge &edge : boruvka.edges) {
+    EXPECT_TRUE(set.Unite(edge.from - 1, edge.to - 1));
+  }
+}
+
+TEST(DisjointSet, UniteAndFind) {
+  s21::DisjointSet set(6);
+  EXPECT_TRUE(set.Unite(0, 1));
+  EXPECT_TRUE(set.Unite(2, 3));
+  EXPECT_TRUE(set.Unite(1, 3));
+  EXPECT_FALSE(set.Unite(0, 2));
+  EXPECT_EQ(set.Find(0), set.Find(3));
+  EXPECT_NE(set.Find(0), set.Find(4));
+  EXPECT_EQ(set.Count(), 3);
+}
+
 TEST(SolveTravelingSalesmanProblem, WeightedUndirectedGraph) {
   Graph test_graph;
   s21::TsmResult result;
@@ -336,6 +1148,183 @@ TEST(SolveTravelingSalesmanProblem, wug3) {
   EXPECT_EQ(result.distance, expected.distance);
 }
 
+TEST(SolveTravelingSalesmanProblem, SeededRunsMatchAcrossThreadCounts) {
+  Graph test_graph;
+  test_graph.LoadGraphFromFile("tests/examples/weighted_undirected_graph.txt");
+  s21::TsmOptions options;
+  options.iterations = 50;
+  options.seed = 42;
+  options.threads = 1;
+  options.exact_limit = 0;
+  s21::TsmResult single =
+      GraphAlgorithms::SolveTravelingSalesmanProblem(test_graph, options);
+  options.threads = 3;
+  s21::TsmResult parallel =
+      GraphAlgorithms::SolveTravelingSalesmanProblem(test_graph, options);
+  EXPECT_EQ(single.vertices, parallel.vertices);
+  EXPECT_EQ(single.distance, parallel.distance);
+  EXPECT_EQ(static_cast<int>(single.vertices.size()), test_graph.Size() + 1);
+}
+
+TEST(SolveTravelingSalesmanProblem, ProgressAndEarlyStops) {
+  Graph test_graph;
+  test_graph.LoadGraphFromFile("tests/examples/weighted_undirected_graph.txt");
+  s21::TsmOptions options;
+  options.seed = 7;
+  // The polished tour would be optimal from the first iteration on.
+  options.local_search = false;
+  options.exact_limit = 0;
+  vector<double> reported;
+  options.progress = [&reported](const s21::TsmProgress &progress) {
+    EXPECT_EQ(progress.best.vertices.front(), progress.best.vertices.back());
+    reported.push_back(progress.best.distance);
+    return reported.size() < 2;
+  };
+  s21::TsmResult stopped =
+      GraphAlgorithms::SolveTravelingSalesmanProblem(test_graph, options);
+  ASSERT_EQ(reported.size(), 2u);
+  EXPECT_LT(reported[1], reported[0]);
+  EXPECT_EQ(stopped.distance, reported[1]);
+
+  options.progress = nullptr;
+  options.iterations = 1000000000;
+  options.stagnation_limit = 0;
+  options.time_budget = 0.2;
+  auto started = std::chrono::steady_clock::now();
+  s21::TsmResult timed =
+      GraphAlgorithms::SolveTravelingSalesmanProblem(test_graph, options);
+  EXPECT_LT(std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                          started)
+                .count(),
+            5.0);
+  EXPECT_EQ(static_cast<int>(timed.vertices.size()), test_graph.Size() + 1);
+
+  options.rho = 0.0;
+  EXPECT_ANY_THROW(
+      GraphAlgorithms::SolveTravelingSalesmanProblem(test_graph, options));
+}
+
+TEST(SolveTravelingSalesmanProblem, ImproveTourNeverLengthens) {
+  for (const char *file : {"tests/examples/weighted_undirected_graph.txt",
+                           "tests/examples/wug2.txt",
+                           "tests/examples/wug3.txt"}) {
+    Graph test_graph;
+    test_graph.LoadGraphFromFile(file);
+    int size = test_graph.Size();
+    s21::TsmResult tour;
+    tour.distance = 0;
+    for (int vertex = 1; vertex <= size; ++vertex) {
+      tour.vertices.push_back(vertex);
+      tour.distance +=
+          test_graph.GetEdgeWeight(vertex - 1, vertex == size ? 0 : vertex);
+    }
+    tour.vertices.push_back(1);
+    s21::TsmResult improved = GraphAlgorithms::ImproveTour(test_graph, tour);
+    EXPECT_LE(improved.distance, tour.distance) << file;
+    ASSERT_EQ(static_cast<int>(improved.vertices.size()), size + 1) << file;
+    EXPECT_EQ(improved.vertices.front(), 1);
+    EXPECT_EQ(improved.vertices.back(), 1);
+    double length = 0;
+    vector<int> sorted(improved.vertices.begin(), improved.vertices.end() - 1);
+    for (int i = 0; i < size; ++i) {
+      length += test_graph.GetEdgeWeight(improved.vertices[i] - 1,
+                                         improved.vertices[i + 1] - 1);
+    }
+    EXPECT_EQ(length, improved.distance) << file;
+    std::sort(sorted.begin(), sorted.end());
+    for (int i = 0; i < size; ++i) {
+      EXPECT_EQ(sorted[i], i + 1);
+    }
+  }
+
+  Graph test_graph;
+  test_graph.LoadGraphFromFile("tests/examples/wug2.txt");
+  s21::TsmResult broken = {{1, 2, 2, 3, 1}, 0};
+  EXPECT_ANY_THROW(GraphAlgorithms::ImproveTour(test_graph, broken));
+}
+
+TEST(SolveTravelingSalesmanProblem, LocalSearchFindsOptimaEarly) {
+  Graph test_graph;
+  test_graph.LoadGraphFromFile("tests/examples/wug3.txt");
+  s21::TsmOptions options;
+  options.iterations = 5;
+  options.seed = 3;
+  options.exact_limit = 0;
+  EXPECT_EQ(
+      GraphAlgorithms::SolveTravelingSalesmanProblem(test_graph, options)
+          .distance,
+      48);
+  test_graph.LoadGraphFromFile("tests/examples/wug2.txt");
+  EXPECT_EQ(
+      GraphAlgorithms::SolveTravelingSalesmanProblem(test_graph, options)
+          .distance,
+      80);
+}
+
+TEST(SolveTravelingSalesmanProblem, HeldKarpMatchesBruteForce) {
+  const char *path = "tests/held_karp.txt";
+  const int size = 9;
+  std::srand(11);
+  vector<vector<int>> matrix(size, vector<int>(size, 0));
+  {
+    std::ofstream out(path);
+    out << size << "\n";
+    for (int i = 0; i < size; ++i) {
+      for (int j = 0; j < size; ++j) {
+        if (i != j && std::rand() % 4 != 0) {
+          matrix[i][j] = 1 + std::rand() % 50;
+        }
+        out << matrix[i][j] << (j + 1 == size ? "\n" : " ");
+      }
+    }
+  }
+  Graph test_graph;
+  test_graph.LoadGraphFromFile(path);
+  std::remove(path);
+
+  vector<int> order(size - 1);
+  for (int i = 0; i < size - 1; ++i) {
+    order[i] = i + 1;
+  }
+  double best = std::numeric_limits<double>::max();
+  do {
+    double length = 0;
+    int from = 0;
+    for (int i = 0; i <= size - 1 && length >= 0; ++i) {
+      int to = i == size - 1 ? 0 : order[i];
+      length = matrix[from][to] ? length + matrix[from][to] : -1;
+      from = to;
+    }
+    if (length >= 0 && length < best) {
+      best = length;
+    }
+  } while (std::next_permutation(order.begin(), order.end()));
+
+  s21::TsmOptions options;
+  for (int threads : {1, 3}) {
+    options.threads = threads;
+    s21::TsmResult exact =
+        GraphAlgorithms::SolveTravelingSalesmanProblem(test_graph, options);
+    EXPECT_EQ(exact.distance, best);
+    ASSERT_EQ(static_cast<int>(exact.vertices.size()), size + 1);
+    double length = 0;
+    for (int i = 0; i < size; ++i) {
+      length += matrix[exact.vertices[i] - 1][exact.vertices[i + 1] - 1];
+    }
+    EXPECT_EQ(length, best);
+  }
+
+  test_graph.LoadGraphFromFile("tests/examples/wug3.txt");
+  EXPECT_EQ(
+      GraphAlgorithms::SolveTravelingSalesmanProblem(test_graph).distance, 48);
+  test_graph.LoadGraphFromFile("tests/examples/wug2.txt");
+  EXPECT_EQ(
+      GraphAlgorithms::SolveTravelingSalesmanProblem(test_graph).distance, 80);
+  options.exact_limit = s21::kMaxExactTsmLimit + 1;
+  EXPECT_ANY_THROW(
+      GraphAlgorithms::SolveTravelingSalesmanProblem(test_graph, options));
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,9 @@
+# from to weight, 0-based
+0 1 1
+0 3 2
+1 2 1
+2 0 1
+2 3 1
+3 0 5
+3 1 1
+3 3 1
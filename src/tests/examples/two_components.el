@@ -0,0 +1,3 @@
+# two separate arcs
+0 1 3
+2 3 4
@@ -65,6 +65,11 @@ void ConsoleView::ShowError(const std::string &error) {
   std::cout << error << std::endl;
 }
 
+void ConsoleView::DisplayLoadStats(const LoadStats &stats) const {
+  std::cout << "Loaded " << stats.bytes << " bytes in " << stats.seconds
+            << " s (" << stats.MegabytesPerSecond() << " MB/s)" << std::endl;
+}
+
 void ConsoleView::HandleTravelingSalesmanProblem(const TsmResult &tsm_result) const {
     if (std::numeric_limits<double>::max() == tsm_result.distance) {
       std::cout << "path not found";
@@ -19,6 +19,7 @@ class ConsoleView {
   void ShowError(const std::string &);
 
   // actions after interaction
+  void DisplayLoadStats(const LoadStats &stats) const;
   void HandleTravelingSalesmanProblem(const TsmResult &) const;
   void DisplayTraversal(const std::vector<int>& traversal) const;
   void DisplayShortestPath(const int& shortest_path) const;